@@ -3,6 +3,8 @@ QT       += core gui charts
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 CONFIG += c++17
+QMAKE_CXXFLAGS += -march=native
+CONFIG(debug, debug|release): DEFINES += S21_BOUNDS_CHECK
 INCLUDEPATH += model
 INCLUDEPATH += controller
 INCLUDEPATH += view
@@ -15,21 +17,41 @@ SOURCES += \
     view/view.cc \
     view/draw.cc \
     view/spinner.cc \
+    model/activation.cc \
+    model/csv_parser.cc \
+    model/data_source.cc \
     model/emnist.cc \
+    model/inference_model.cc \
     model/layers.cc \
+    model/learning_session.cc \
+    model/mapped_file.cc \
     model/network.cc \
-    model/sigmoid.cc \
+    model/sample_store.cc \
+    model/static_network.cc \
+    model/thread_pool.cc \
+    model/weights_file.cc \
     controller/controller.cc \
 
 HEADERS += \
     view/view.h \
     view/draw.h \
     view/spinner.h \
+    model/activation.h \
+    model/csv_parser.h \
+    model/data_source.h \
     model/emnist.h \
+    model/inference_model.h \
+    model/kernels.h \
     model/layers.h \
+    model/learning_session.h \
+    model/mapped_file.h \
     model/network.h \
     model/s21_matrix.h \
-    model/sigmoid.h \
+    model/sample_store.h \
+    model/span.h \
+    model/static_network.h \
+    model/thread_pool.h \
+    model/weights_file.h \
     controller/controller.h \
 
 FORMS += \
@@ -0,0 +1,370 @@
+#include <benchmark/benchmark.h>
+#include <stdlib.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "activation.h"
+#include "emnist.h"
+#include "inference_model.h"
+#include "layers.h"
+#include "s21_matrix.h"
+#include "weights_file.h"
+
+namespace {
+using s21::S21Matrix;
+
+constexpr size_t kInputs = 784;
+constexpr size_t kHidden = 50;
+constexpr size_t kOutputs = 26;
+constexpr size_t kDatasetSize = 4096;
+
+S21Matrix<double> RandomMatrix(size_t rows, size_t cols, std::mt19937& gen) {
+  std::uniform_real_distribution<double> dist(-0.1, 0.1);
+  S21Matrix<double> result(rows, cols);
+  for (size_t row = 0; row < rows; ++row)
+    for (size_t col = 0; col < cols; ++col) result(row, col) = dist(gen);
+  return result;
+}
+
+std::vector<size_t> LayerSizes(size_t hidden_layers_count) {
+  std::vector<size_t> layer_sizes(hidden_layers_count + 2, kHidden);
+  layer_sizes.front() = kInputs;
+  layer_sizes.back() = kOutputs;
+  return layer_sizes;
+}
+
+// The weights are drawn in double and converted to T, so every precision
+// runs the same network.
+template <class T = double>
+struct Model {
+  explicit Model(size_t hidden_layers_count)
+      : Model(LayerSizes(hidden_layers_count)) {}
+  explicit Model(const std::vector<size_t>& layer_sizes)
+      : layer_sizes(layer_sizes) {
+    std::mt19937 gen(42);
+    for (size_t layer = 0; layer + 1 < layer_sizes.size(); ++layer) {
+      weights.emplace_back(
+          RandomMatrix(layer_sizes[layer + 1], layer_sizes[layer], gen));
+      biases.emplace_back(RandomMatrix(layer_sizes[layer + 1], 1, gen));
+    }
+  }
+
+  std::vector<size_t> layer_sizes;
+  std::vector<S21Matrix<T>> weights;
+  std::vector<S21Matrix<T>> biases;
+};
+
+template <class T = double>
+S21Matrix<T> RandomImages(size_t count) {
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  S21Matrix<T> images(kInputs, count);
+  for (size_t row = 0; row < kInputs; ++row)
+    for (size_t col = 0; col < count; ++col) images(row, col) = dist(gen);
+  return images;
+}
+
+std::vector<size_t> RandomClasses(size_t count) {
+  std::vector<size_t> classes(count);
+  for (size_t i = 0; i < count; ++i) classes[i] = i % kOutputs;
+  return classes;
+}
+
+// Paths of the benchmark dataset. MLP_BENCH_DATASET and MLP_BENCH_MAPPING
+// select a real CSV dataset; otherwise a synthetic one is generated. The
+// binary copy, generated files and saved weights live in a temporary
+// directory.
+struct Dataset {
+  Dataset() {
+    char directory_template[] = "/tmp/mlp_bench_XXXXXX";
+    if (!mkdtemp(directory_template))
+      throw std::runtime_error("Unable to create a temporary directory");
+    directory = directory_template;
+    const char* dataset = std::getenv("MLP_BENCH_DATASET");
+    const char* mapping = std::getenv("MLP_BENCH_MAPPING");
+    if (dataset && mapping) {
+      csv_path = dataset;
+      mapping_path = mapping;
+    } else {
+      csv_path = directory + "/dataset.csv";
+      mapping_path = directory + "/mapping.txt";
+      std::ofstream mapping_stream(mapping_path);
+      for (size_t i = 1; i <= kOutputs; ++i)
+        mapping_stream << i << ' ' << 64 + i << ' ' << 96 + i << '\n';
+      std::ofstream csv_stream(csv_path);
+      std::mt19937 gen(1);
+      for (size_t sample = 0; sample < kDatasetSize; ++sample) {
+        csv_stream << 1 + sample % kOutputs;
+        for (size_t pixel = 0; pixel < kInputs; ++pixel)
+          csv_stream << ',' << gen() % 256;
+        csv_stream << '\n';
+      }
+    }
+    binary_path = directory + "/dataset.bin";
+    s21::Emnist::ConvertToBinary(csv_path, mapping_path, binary_path);
+  }
+
+  ~Dataset() {
+    std::remove(binary_path.c_str());
+    std::remove((directory + "/dataset.csv").c_str());
+    std::remove((directory + "/mapping.txt").c_str());
+    std::remove(directory.c_str());
+  }
+
+  std::string directory;
+  std::string csv_path;
+  std::string mapping_path;
+  std::string binary_path;
+};
+
+const Dataset& GetDataset() {
+  static Dataset dataset;
+  return dataset;
+}
+
+void HiddenLayers(benchmark::internal::Benchmark* benchmark) {
+  benchmark->DenseRange(2, 5);
+}
+
+void HiddenLayersAndMiniBatch(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgsProduct({benchmark::CreateDenseRange(2, 5, 1),
+                          benchmark::CreateRange(1, 512, 2)});
+}
+
+void MiniBatch(benchmark::internal::Benchmark* benchmark) {
+  benchmark->RangeMultiplier(2)->Range(1, 512);
+}
+
+void BM_MulMatrix(benchmark::State& state) {
+  std::mt19937 gen(3);
+  auto weights = RandomMatrix(kHidden, kInputs, gen);
+  auto images = RandomImages(state.range(0));
+  for (auto _ : state) {
+    S21Matrix<double> result = weights * images;
+    benchmark::DoNotOptimize(result(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_MulMatrix)->Apply(MiniBatch);
+
+void BM_Transpose(benchmark::State& state) {
+  auto images = RandomImages(state.range(0));
+  for (auto _ : state) {
+    auto result = images.Transpose();
+    benchmark::DoNotOptimize(result(0, 0));
+  }
+}
+BENCHMARK(BM_Transpose)->Apply(MiniBatch);
+
+void BM_UseFunction(benchmark::State& state) {
+  std::mt19937 gen(3);
+  auto neurons = RandomMatrix(kHidden, state.range(0), gen);
+  for (auto _ : state) {
+    neurons.UseFunction([](double x) { return 1.0 / (1.0 + std::exp(-x)); });
+    benchmark::DoNotOptimize(neurons(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * kHidden * state.range(0));
+}
+BENCHMARK(BM_UseFunction)->Apply(MiniBatch);
+
+template <s21::ActivationFunction activation>
+void BM_ActivateHidden(benchmark::State& state) {
+  std::mt19937 gen(3);
+  auto neurons = RandomMatrix(kHidden, state.range(0), gen);
+  auto biases = RandomMatrix(kHidden, 1, gen);
+  s21::NetworkFunctions functions;
+  functions.activation = activation;
+  for (auto _ : state) {
+    functions.ActivateHidden(kHidden, state.range(0), biases.Data(),
+                             neurons.Data());
+    benchmark::DoNotOptimize(neurons(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * kHidden * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_ActivateHidden, s21::ActivationFunction::kSigmoid)
+    ->Apply(MiniBatch);
+BENCHMARK_TEMPLATE(BM_ActivateHidden, s21::ActivationFunction::kRelu)
+    ->Apply(MiniBatch);
+BENCHMARK_TEMPLATE(BM_ActivateHidden, s21::ActivationFunction::kTanh)
+    ->Apply(MiniBatch);
+
+void BM_ActivateSoftmax(benchmark::State& state) {
+  std::mt19937 gen(3);
+  auto neurons = RandomMatrix(kOutputs, state.range(0), gen);
+  auto biases = RandomMatrix(kOutputs, 1, gen);
+  s21::NetworkFunctions functions;
+  functions.loss = s21::LossFunction::kCrossEntropy;
+  for (auto _ : state) {
+    functions.ActivateOutput(kOutputs, state.range(0), biases.Data(),
+                             neurons.Data());
+    benchmark::DoNotOptimize(neurons(0, 0));
+  }
+  state.SetItemsProcessed(state.iterations() * kOutputs * state.range(0));
+}
+BENCHMARK(BM_ActivateSoftmax)->Apply(MiniBatch);
+
+template <template <class> class LayersType, class T = double>
+void BM_FeedForward(benchmark::State& state) {
+  Model<T> model(state.range(0));
+  LayersType<T> layers(model.layer_sizes);
+  auto image = RandomImages<T>(1);
+  for (auto _ : state) {
+    layers.FeedForward(image, model.weights, model.biases);
+    benchmark::DoNotOptimize(layers.GetMaxOutputIndex());
+  }
+}
+BENCHMARK_TEMPLATE(BM_FeedForward, s21::MatrixLayers)->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_FeedForward, s21::GraphLayers)->Apply(HiddenLayers);
+
+template <template <class> class LayersType, class T = double>
+void BM_BackPropogation(benchmark::State& state) {
+  Model<T> model(state.range(0));
+  LayersType<T> layers(model.layer_sizes);
+  auto image = RandomImages<T>(1);
+  layers.FeedForward(image, model.weights, model.biases);
+  for (auto _ : state) layers.BackPropogation(0, model.weights);
+}
+BENCHMARK_TEMPLATE(BM_BackPropogation, s21::MatrixLayers)
+    ->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_BackPropogation, s21::GraphLayers)->Apply(HiddenLayers);
+
+template <template <class> class LayersType, class T = double>
+void BM_TrainMiniBatch(benchmark::State& state) {
+  Model<T> model(state.range(0));
+  LayersType<T> layers(model.layer_sizes);
+  layers.SetMiniBatchSize(state.range(1));
+  auto images = RandomImages<T>(state.range(1));
+  auto classes = RandomClasses(state.range(1));
+  std::vector<double> losses;
+  for (auto _ : state) {
+    losses.clear();
+    layers.TrainMiniBatch(images, classes, model.weights, model.biases, losses);
+    layers.UpdateWeights(model.weights, model.biases, 0.01);
+    layers.ResetDeltas();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK_TEMPLATE(BM_TrainMiniBatch, s21::MatrixLayers)
+    ->Apply(HiddenLayersAndMiniBatch);
+BENCHMARK_TEMPLATE(BM_TrainMiniBatch, s21::GraphLayers)
+    ->Apply(HiddenLayersAndMiniBatch);
+BENCHMARK_TEMPLATE(BM_TrainMiniBatch, s21::MatrixLayers, float)
+    ->Apply(HiddenLayersAndMiniBatch);
+
+template <template <class> class LayersType, class T = double>
+void BM_PredictBatch(benchmark::State& state) {
+  Model<T> model(state.range(0));
+  LayersType<T> layers(model.layer_sizes);
+  auto images = RandomImages<T>(state.range(1));
+  std::vector<size_t> predictions;
+  for (auto _ : state) {
+    predictions.clear();
+    layers.PredictBatch(images, model.weights, model.biases, predictions);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK_TEMPLATE(BM_PredictBatch, s21::MatrixLayers)
+    ->Apply(HiddenLayersAndMiniBatch);
+BENCHMARK_TEMPLATE(BM_PredictBatch, s21::GraphLayers)
+    ->Apply(HiddenLayersAndMiniBatch);
+BENCHMARK_TEMPLATE(BM_PredictBatch, s21::MatrixLayers, float)
+    ->Apply(HiddenLayersAndMiniBatch);
+
+// Two hidden layers of state.range(0) neurons, classifying 256 images.
+void BM_PredictBatchWidth(benchmark::State& state) {
+  Model model({kInputs, static_cast<size_t>(state.range(0)),
+               static_cast<size_t>(state.range(0)), kOutputs});
+  s21::MatrixLayers<double> layers(model.layer_sizes);
+  auto images = RandomImages(256);
+  std::vector<size_t> predictions;
+  for (auto _ : state) {
+    predictions.clear();
+    layers.PredictBatch(images, model.weights, model.biases, predictions);
+  }
+  state.SetItemsProcessed(state.iterations() * 256);
+}
+BENCHMARK(BM_PredictBatchWidth)->RangeMultiplier(2)->Range(16, 512);
+
+// Latency of one image through InferenceModel, with the StaticEngine of
+// the topology or with the generic kernels.
+template <bool StaticEngine, class T = double>
+void BM_PredictImage(benchmark::State& state) {
+  Model<T> model(state.range(0));
+  s21::InferenceModel<T> inference_model(
+      model.weights, model.biases,
+      s21::Emnist::GetDefaultLabels(model.weights.back().GetRows()), {},
+      StaticEngine);
+  auto image = RandomImages<T>(1);
+  typename s21::InferenceModel<T>::Scratch scratch;
+  for (auto _ : state)
+    benchmark::DoNotOptimize(inference_model.Predict(image, scratch));
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK_TEMPLATE(BM_PredictImage, true)->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_PredictImage, false)->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_PredictImage, true, float)->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_PredictImage, false, float)->Apply(HiddenLayers);
+
+void BM_LoadDatasetCsv(benchmark::State& state) {
+  const auto& dataset = GetDataset();
+  for (auto _ : state) {
+    auto samples =
+        s21::Emnist::LoadDataset(dataset.csv_path, dataset.mapping_path);
+    state.SetItemsProcessed(state.items_processed() + samples.GetSize());
+  }
+}
+BENCHMARK(BM_LoadDatasetCsv)->Unit(benchmark::kMillisecond);
+
+void BM_LoadDatasetBinary(benchmark::State& state) {
+  const auto& dataset = GetDataset();
+  for (auto _ : state) {
+    auto samples =
+        s21::Emnist::LoadDataset(dataset.binary_path, dataset.mapping_path);
+    state.SetItemsProcessed(state.items_processed() + samples.GetSize());
+  }
+}
+BENCHMARK(BM_LoadDatasetBinary);
+
+std::string GetWeightsPath(s21::WeightsFile::Format format) {
+  return GetDataset().directory + "/weights_" +
+         std::to_string(static_cast<int>(format));
+}
+
+template <s21::WeightsFile::Format format>
+void BM_SaveWeights(benchmark::State& state) {
+  Model model(state.range(0));
+  std::string path = GetWeightsPath(format);
+  for (auto _ : state)
+    s21::WeightsFile::Save(path, model.weights, model.biases, format);
+  std::remove(path.c_str());
+}
+BENCHMARK_TEMPLATE(BM_SaveWeights, s21::WeightsFile::Format::kBinary)
+    ->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_SaveWeights, s21::WeightsFile::Format::kText)
+    ->Apply(HiddenLayers)
+    ->Unit(benchmark::kMillisecond);
+
+template <s21::WeightsFile::Format format>
+void BM_LoadWeights(benchmark::State& state) {
+  Model model(state.range(0));
+  std::string path = GetWeightsPath(format);
+  s21::WeightsFile::Save(path, model.weights, model.biases, format);
+  for (auto _ : state)
+    benchmark::DoNotOptimize(
+        s21::WeightsFile::Load(path, model.weights, model.biases));
+  std::remove(path.c_str());
+}
+BENCHMARK_TEMPLATE(BM_LoadWeights, s21::WeightsFile::Format::kBinary)
+    ->Apply(HiddenLayers);
+BENCHMARK_TEMPLATE(BM_LoadWeights, s21::WeightsFile::Format::kText)
+    ->Apply(HiddenLayers)
+    ->Unit(benchmark::kMillisecond);
+}  // namespace
+
+BENCHMARK_MAIN();
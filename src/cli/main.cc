@@ -0,0 +1,317 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "command_line.h"
+#include "controller.h"
+
+namespace {
+using Clock = std::chrono::steady_clock;
+using Options = std::map<std::string, std::string>;
+
+const char kUsage[] =
+    "Usage: mlp_cli COMMAND [OPTIONS]\n"
+    "Commands:\n"
+    "  train    --train FILE --test FILE --mapping FILE [--epochs N]\n"
+    "           [--streaming] [--shuffle-buffer N] [--save FILE]\n"
+    "  cv       --train FILE --mapping FILE [--k N] [--independent-folds]\n"
+    "           [--save FILE]\n"
+    "  test     --test FILE --mapping FILE --weights FILE [--sample-part X]\n"
+    "  convert  --csv FILE --mapping FILE --output FILE [--threads N]\n"
+    "Network options:\n"
+    "  --implementation matrix|graph  --hidden-layers N  --mini-batch N\n"
+    "  --hidden-sizes N,N,...  --classes N  --threads N  --per-sample\n"
+    "  --activation sigmoid|relu|leaky-relu|tanh  --loss mse|cross-entropy\n"
+    "  --precision double|float|mixed\n"
+    "Weights given to --save are written in binary unless the name ends in\n"
+    ".txt. Binary weights record the activation, loss and class labels,\n"
+    "which test takes from the file together with the layer sizes.\n"
+    "--hidden-sizes gives the width of every hidden layer and overrides\n"
+    "--hidden-layers. --classes has to match the number of classes in the\n"
+    "mapping. --precision float trains in float32 and saves float32 weights;\n"
+    "mixed computes in float32, sums gradients in double and keeps and saves\n"
+    "double weights. Results are printed to stdout as one JSON object per\n"
+    "line.\n";
+
+// Flags without a value are stored as "1". Fails on options not in kUsage.
+bool ParseOptions(int argc, char* argv[], Options& options) {
+  const std::vector<std::string> switches = {"--streaming",
+                                             "--independent-folds",
+                                             "--per-sample"};
+  const std::vector<std::string> valued = {
+      "--train", "--test", "--mapping", "--epochs", "--save",
+      "--shuffle-buffer", "--k", "--weights", "--sample-part", "--csv",
+      "--output", "--implementation", "--mini-batch", "--hidden-layers",
+      "--hidden-sizes", "--classes", "--threads", "--activation", "--loss",
+      "--precision"};
+  auto contains = [](const std::vector<std::string>& names,
+                     const std::string& name) {
+    return std::find(names.begin(), names.end(), name) != names.end();
+  };
+  for (int i = 2; i < argc; ++i) {
+    std::string arg = argv[i];
+    if (contains(switches, arg)) {
+      options[arg] = "1";
+    } else if (!contains(valued, arg)) {
+      return false;
+    } else if (i + 1 < argc) {
+      options[arg] = argv[++i];
+    } else {
+      return false;
+    }
+  }
+  return true;
+}
+
+const std::string& Require(const Options& options, const std::string& name) {
+  auto it = options.find(name);
+  if (it == options.end())
+    throw s21::UsageError("Missing required option " + name);
+  return it->second;
+}
+
+size_t GetSize(const Options& options, const std::string& name,
+               size_t default_value,
+               size_t max_value = std::numeric_limits<size_t>::max()) {
+  auto it = options.find(name);
+  if (it == options.end()) return default_value;
+  return s21::CommandLine::ParseSize(name, it->second, 0, max_value);
+}
+
+size_t GetThreadsCount(const Options& options, size_t default_value) {
+  constexpr size_t kMaxThreadsCount = 1024;
+  return GetSize(options, "--threads", default_value, kMaxThreadsCount);
+}
+
+// Weights files store layer sizes and the layer count as 32-bit numbers.
+std::vector<size_t> GetLayerSizes(const Options& options) {
+  const size_t max_size = std::numeric_limits<uint32_t>::max();
+  std::vector<size_t> layer_sizes(1, s21::Emnist::kImageSize);
+  auto hidden_sizes = options.find("--hidden-sizes");
+  if (hidden_sizes != options.end()) {
+    const char* begin = hidden_sizes->second.c_str();
+    while (true) {
+      char* end = nullptr;
+      size_t size = s21::CommandLine::ParseSize("--hidden-sizes", begin, &end,
+                                                0, max_size);
+      if (*end != ',' && *end != '\0')
+        throw s21::UsageError("Option --hidden-sizes expects numbers");
+      layer_sizes.push_back(size);
+      if (*end == '\0') break;
+      begin = end + 1;
+    }
+  } else {
+    layer_sizes.insert(layer_sizes.end(),
+                       GetSize(options, "--hidden-layers", 2, max_size),
+                       s21::Network::kDefaultHiddenLayerSize);
+  }
+  layer_sizes.push_back(GetSize(options, "--classes",
+                                s21::Network::kDefaultClassesCount, max_size));
+  return layer_sizes;
+}
+
+double GetSeconds(Clock::time_point start) {
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void PrintResult(const std::string& event, size_t index,
+                 const s21::NetworkBase::TestResults& result) {
+  std::cout << "{\"event\":\"" << event << "\",\"index\":" << index
+            << ",\"accuracy\":" << result.average_accuracy
+            << ",\"precision\":" << result.precision
+            << ",\"recall\":" << result.recall
+            << ",\"f_measure\":" << result.f_measure
+            << ",\"loss\":" << result.average_loss
+            << ",\"test_time_s\":" << result.total_time << "}\n";
+}
+
+// setup_time_s is reported only by commands with a separate setup phase.
+void PrintSummary(const std::string& command,
+                  std::optional<double> setup_time, double run_time,
+                  size_t threads_count) {
+  std::cout << "{\"event\":\"summary\",\"command\":\"" << command
+            << "\",\"threads\":" << threads_count;
+  if (setup_time) std::cout << ",\"setup_time_s\":" << *setup_time;
+  std::cout << ",\"run_time_s\":" << run_time << "}\n";
+}
+
+s21::NetworkFunctions GetFunctions(const Options& options) {
+  s21::NetworkFunctions functions;
+  auto activation = options.find("--activation");
+  if (activation != options.end()) {
+    if (activation->second == "relu")
+      functions.activation = s21::ActivationFunction::kRelu;
+    else if (activation->second == "leaky-relu")
+      functions.activation = s21::ActivationFunction::kLeakyRelu;
+    else if (activation->second == "tanh")
+      functions.activation = s21::ActivationFunction::kTanh;
+    else if (activation->second != "sigmoid")
+      throw std::runtime_error("Unknown activation " + activation->second);
+  }
+  auto loss = options.find("--loss");
+  if (loss != options.end()) {
+    if (loss->second == "cross-entropy")
+      functions.loss = s21::LossFunction::kCrossEntropy;
+    else if (loss->second != "mse")
+      throw std::runtime_error("Unknown loss " + loss->second);
+  }
+  return functions;
+}
+
+template <class C>
+void ConfigureNetwork(C& controller, const Options& options) {
+  auto implementation = options.find("--implementation");
+  if (implementation != options.end()) {
+    if (implementation->second == "graph")
+      controller.ChangeImplenetation(
+          s21::Network::NetworkImplementation::kGraphForm);
+    else if (implementation->second != "matrix")
+      throw std::runtime_error("Unknown implementation " +
+                               implementation->second);
+  }
+  controller.SetLayerSizes(GetLayerSizes(options));
+  controller.SetMBSize(GetSize(options, "--mini-batch", 32));
+  controller.SetThreadsCount(GetThreadsCount(options, 1));
+  controller.SetBatchedTraining(options.count("--per-sample") == 0);
+  controller.SetNetworkFunctions(GetFunctions(options));
+}
+
+template <class C>
+void SaveWeights(C& controller, const Options& options) {
+  auto path = options.find("--save");
+  if (path == options.end()) return;
+  const std::string& name = path->second;
+  bool text =
+      name.size() >= 4 && name.compare(name.size() - 4, 4, ".txt") == 0;
+  controller.SaveWeightsAndBiases(
+      name, text ? s21::WeightsFile::Format::kText
+                 : s21::WeightsFile::Format::kBinary);
+}
+
+template <class C>
+void Train(C& controller, const Options& options) {
+  auto start = Clock::now();
+  auto epochs_count = GetSize(options, "--epochs", 1);
+  std::vector<s21::NetworkBase::TestResults> results;
+  if (options.count("--streaming"))
+    results = controller.StartLearningStreaming(
+        Require(options, "--train"), Require(options, "--test"),
+        Require(options, "--mapping"), epochs_count,
+        GetSize(options, "--shuffle-buffer",
+                s21::Network::kDefaultShuffleBufferSize));
+  else
+    results = controller.StartLearning(
+        Require(options, "--train"), Require(options, "--test"),
+        Require(options, "--mapping"), epochs_count);
+  double run_time = GetSeconds(start);
+  for (size_t epoch = 0; epoch < results.size(); ++epoch)
+    PrintResult("epoch", epoch, results[epoch]);
+  SaveWeights(controller, options);
+  PrintSummary("train", std::nullopt, run_time, GetThreadsCount(options, 1));
+}
+
+template <class C>
+void CrossValidate(C& controller, const Options& options) {
+  auto start = Clock::now();
+  auto results = controller.StartLearningWithCrossValidation(
+      Require(options, "--train"), Require(options, "--mapping"),
+      GetSize(options, "--k", 5), options.count("--independent-folds") != 0);
+  double run_time = GetSeconds(start);
+  for (size_t fold = 0; fold < results.size(); ++fold)
+    PrintResult("fold", fold, results[fold]);
+  SaveWeights(controller, options);
+  PrintSummary("cv", std::nullopt, run_time, GetThreadsCount(options, 1));
+}
+
+template <class C>
+void Test(C& controller, const Options& options) {
+  auto start = Clock::now();
+  const std::string& weights = Require(options, "--weights");
+  if (!controller.LoadWeightsAndBiases(weights))
+    throw std::runtime_error("Unable to load weights from " + weights);
+  double load_time = GetSeconds(start);
+  start = Clock::now();
+  double sample_part = 1.0;
+  auto part = options.find("--sample-part");
+  if (part != options.end())
+    sample_part = s21::CommandLine::ParseFraction(part->first, part->second);
+  auto result = controller.RunTests(Require(options, "--test"),
+                                    Require(options, "--mapping"),
+                                    sample_part);
+  double run_time = GetSeconds(start);
+  PrintResult("test", 0, result);
+  PrintSummary("test", load_time, run_time, GetThreadsCount(options, 1));
+}
+
+void Convert(const Options& options) {
+  auto start = Clock::now();
+  s21::ThreadPool thread_pool(GetThreadsCount(
+      options, std::max(std::thread::hardware_concurrency(), 1u)));
+  s21::Emnist::ConvertToBinary(
+      Require(options, "--csv"), Require(options, "--mapping"),
+      Require(options, "--output"), thread_pool);
+  PrintSummary("convert", std::nullopt, GetSeconds(start),
+               thread_pool.GetThreadsCount());
+}
+
+// Returns false for an unknown command.
+template <class C>
+bool Run(const std::string& command, const Options& options) {
+  C controller;
+  ConfigureNetwork(controller, options);
+  if (command == "train")
+    Train(controller, options);
+  else if (command == "cv")
+    CrossValidate(controller, options);
+  else if (command == "test")
+    Test(controller, options);
+  else
+    return false;
+  return true;
+}
+
+bool Run(const std::string& command, const Options& options) {
+  auto precision = options.find("--precision");
+  if (precision == options.end() || precision->second == "double")
+    return Run<s21::Controller>(command, options);
+  if (precision->second == "float")
+    return Run<s21::BasicController<float>>(command, options);
+  if (precision->second == "mixed")
+    return Run<s21::BasicController<float, double>>(command, options);
+  throw std::runtime_error("Unknown precision " + precision->second);
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  Options options;
+  if (argc < 2 || !ParseOptions(argc, argv, options)) {
+    std::cerr << kUsage;
+    return 2;
+  }
+  std::string command = argv[1];
+  std::cout.precision(9);
+  try {
+    if (command == "convert") {
+      Convert(options);
+      return 0;
+    }
+    if (!Run(command, options)) {
+      std::cerr << kUsage;
+      return 2;
+    }
+  } catch (const s21::UsageError& error) {
+    std::cerr << error.what() << '\n' << kUsage;
+    return 2;
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
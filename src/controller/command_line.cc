@@ -0,0 +1,42 @@
+#include "command_line.h"
+
+#include <cerrno>
+#include <cstdlib>
+
+namespace s21 {
+size_t CommandLine::ParseSize(const std::string& name, const char* begin,
+                              char** end, size_t min_value,
+                              size_t max_value) {
+  std::string error = "Option " + name + " expects numbers from " +
+                      std::to_string(min_value) + " to " +
+                      std::to_string(max_value);
+  if (*begin < '0' || *begin > '9') throw UsageError(error);
+  errno = 0;
+  unsigned long value = std::strtoul(begin, end, 10);
+  if (errno == ERANGE || value < min_value || value > max_value)
+    throw UsageError(error);
+  return value;
+}
+
+size_t CommandLine::ParseSize(const std::string& name,
+                              const std::string& value, size_t min_value,
+                              size_t max_value) {
+  char* end = nullptr;
+  size_t result = ParseSize(name, value.c_str(), &end, min_value, max_value);
+  if (*end != '\0') throw UsageError("Option " + name + " expects a number");
+  return result;
+}
+
+double CommandLine::ParseFraction(const std::string& name,
+                                  const std::string& value) {
+  const char* begin = value.c_str();
+  char* end = nullptr;
+  errno = 0;
+  double result = std::strtod(begin, &end);
+  bool digit_first = (*begin >= '0' && *begin <= '9') || *begin == '.';
+  if (!digit_first || *end != '\0' || errno == ERANGE ||
+      !(result > 0 && result <= 1))
+    throw UsageError("Option " + name + " expects a number in (0, 1]");
+  return result;
+}
+}  // namespace s21
@@ -0,0 +1,31 @@
+#ifndef CPP7_MLP_CONTROLLER_COMMAND_LINE_H_
+#define CPP7_MLP_CONTROLLER_COMMAND_LINE_H_
+
+#include <stdexcept>
+#include <string>
+
+namespace s21 {
+// Invalid command line values; the tools print their usage text with them.
+class UsageError : public std::runtime_error {
+ public:
+  using std::runtime_error::runtime_error;
+};
+
+// Option value parsing shared by mlp_cli and mlp_server.
+class CommandLine {
+ public:
+  // Parses an unsigned decimal number from min_value to max_value at the
+  // start of begin and points end past it. strtoul alone would accept a
+  // sign and wrap negative numbers around.
+  static size_t ParseSize(const std::string& name, const char* begin,
+                          char** end, size_t min_value, size_t max_value);
+  // Parses the whole of value as such a number.
+  static size_t ParseSize(const std::string& name, const std::string& value,
+                          size_t min_value, size_t max_value);
+  // Parses the whole of value as a fraction in (0, 1].
+  static double ParseFraction(const std::string& name,
+                              const std::string& value);
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_CONTROLLER_COMMAND_LINE_H_
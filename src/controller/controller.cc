@@ -2,45 +2,117 @@
 
 namespace s21 {
 
-void Controller::SaveWeightsAndBiases(const std::string& file_name) {
-  network_.SaveWeightsAndBiases(file_name);
+template <class T, class Master>
+void BasicController<T, Master>::SaveWeightsAndBiases(
+    const std::string& file_name, WeightsFile::Format format) {
+  network_.SaveWeightsAndBiases(file_name, format);
 }
 
-bool Controller::LoadWeightsAndBiases(const std::string& file_name) {
+template <class T, class Master>
+bool BasicController<T, Master>::LoadWeightsAndBiases(
+    const std::string& file_name) {
   return network_.LoadWeightsAndBiases(file_name);
 }
 
-void Controller::ChangeImplenetation(
+template <class T, class Master>
+void BasicController<T, Master>::ChangeImplenetation(
     Network::NetworkImplementation network_implementation) {
   network_.ChangeImplenetation(network_implementation);
 }
 
-void Controller::ChangeHiddenLayersNumber(size_t number) {
+template <class T, class Master>
+void BasicController<T, Master>::ChangeHiddenLayersNumber(size_t number) {
   network_.ChangeHiddenLayersNumber(number);
 }
 
-char Controller::GetPrediction(const S21Matrix<double>& image) const {
+template <class T, class Master>
+void BasicController<T, Master>::SetLayerSizes(
+    const std::vector<size_t>& layer_sizes) {
+  network_.SetLayerSizes(layer_sizes);
+}
+
+template <class T, class Master>
+char BasicController<T, Master>::GetPrediction(
+    const S21Matrix<double>& image) const {
   return network_.GetPrediction(image);
 }
 
-void Controller::SetMBSize(size_t size) { network_.SetMiniBatchSize(size); }
+template <class T, class Master>
+std::vector<InferenceModelBase::Classification>
+BasicController<T, Master>::ClassifyBatch(const uint8_t* pixels,
+                                          size_t images_count,
+                                          size_t top_k) const {
+  return network_.ClassifyBatch(pixels, images_count, top_k);
+}
+
+template <class T, class Master>
+std::shared_ptr<const InferenceModel<T>>
+BasicController<T, Master>::GetInferenceModel() const {
+  return network_.GetInferenceModel();
+}
+
+template <class T, class Master>
+void BasicController<T, Master>::SetMBSize(size_t size) {
+  network_.SetMiniBatchSize(size);
+}
 
-std::vector<Network::TestResults> Controller::StartLearning(
+template <class T, class Master>
+void BasicController<T, Master>::SetBatchedTraining(bool batched) {
+  network_.SetBatchedTraining(batched);
+}
+
+template <class T, class Master>
+void BasicController<T, Master>::SetStaticInference(bool enabled) {
+  network_.SetStaticInference(enabled);
+}
+
+template <class T, class Master>
+void BasicController<T, Master>::SetThreadsCount(size_t threads_count) {
+  network_.SetThreadsCount(threads_count);
+}
+
+template <class T, class Master>
+void BasicController<T, Master>::SetNetworkFunctions(
+    const NetworkFunctions& functions) {
+  network_.SetFunctions(functions);
+}
+
+template <class T, class Master>
+std::vector<Network::TestResults> BasicController<T, Master>::StartLearning(
     const std::string& data_path, const std::string& test_path,
     const std::string& mapping_path, size_t epochs_count) {
   return network_.StartLearning(data_path, test_path, mapping_path,
                                 epochs_count);
 }
 
-std::vector<Network::TestResults> Controller::StartLearningWithCrossValidation(
-    const std::string& data_path, const std::string& mapping_path, size_t k) {
-  return network_.StartLearningWithCrossValidation(data_path, mapping_path, k);
+template <class T, class Master>
+std::vector<Network::TestResults>
+BasicController<T, Master>::StartLearningStreaming(
+    const std::string& data_path, const std::string& test_path,
+    const std::string& mapping_path, size_t epochs_count,
+    size_t shuffle_buffer_size) {
+  return network_.StartLearningStreaming(data_path, test_path, mapping_path,
+                                         epochs_count, shuffle_buffer_size);
+}
+
+template <class T, class Master>
+std::vector<Network::TestResults>
+BasicController<T, Master>::StartLearningWithCrossValidation(
+    const std::string& data_path, const std::string& mapping_path, size_t k,
+    bool independent_folds) {
+  return network_.StartLearningWithCrossValidation(data_path, mapping_path, k,
+                                                   independent_folds);
 }
 
-Network::TestResults Controller::RunTests(const std::string& data_path,
-                                          const std::string& mapping_path,
-                                          double sample_part) {
+template <class T, class Master>
+Network::TestResults BasicController<T, Master>::RunTests(
+    const std::string& data_path, const std::string& mapping_path,
+    double sample_part) {
   return network_.RunTests(data_path, mapping_path, sample_part);
 }
 
+template class BasicController<float>;
+template class BasicController<double>;
+template class BasicController<float, double>;
+
 }  // namespace s21
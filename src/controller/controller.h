@@ -5,29 +5,49 @@
 
 namespace s21 {
 
-class Controller {
+// T and Master select the precision of the network, see BasicNetwork.
+template <class T, class Master = T>
+class BasicController {
  public:
-  Controller() : network_(Network::NetworkImplementation::kMatrixForm, 2) {}
-  void SaveWeightsAndBiases(const std::string& file_name);
+  BasicController()
+      : network_(Network::NetworkImplementation::kMatrixForm, 2) {}
+  void SaveWeightsAndBiases(
+      const std::string& file_name,
+      WeightsFile::Format format = WeightsFile::Format::kBinary);
   bool LoadWeightsAndBiases(const std::string& file_name);
   void ChangeImplenetation(
       Network::NetworkImplementation network_implementation);
   void ChangeHiddenLayersNumber(size_t number);
+  void SetLayerSizes(const std::vector<size_t>& layer_sizes);
   char GetPrediction(const S21Matrix<double>& image) const;
+  std::shared_ptr<const InferenceModel<T>> GetInferenceModel() const;
+  std::vector<InferenceModelBase::Classification> ClassifyBatch(
+      const uint8_t* pixels, size_t images_count, size_t top_k) const;
   void SetMBSize(size_t size);
+  void SetBatchedTraining(bool batched);
+  void SetStaticInference(bool enabled);
+  void SetThreadsCount(size_t threads_count);
+  void SetNetworkFunctions(const NetworkFunctions& functions);
   std::vector<Network::TestResults> StartLearning(
       const std::string& data_path, const std::string& test_path,
       const std::string& mapping_path, size_t epochs_count);
+  std::vector<Network::TestResults> StartLearningStreaming(
+      const std::string& data_path, const std::string& test_path,
+      const std::string& mapping_path, size_t epochs_count,
+      size_t shuffle_buffer_size = Network::kDefaultShuffleBufferSize);
   std::vector<Network::TestResults> StartLearningWithCrossValidation(
-      const std::string& dataPath, const std::string& mapping_path, size_t k);
+      const std::string& dataPath, const std::string& mapping_path, size_t k,
+      bool independent_folds = false);
   Network::TestResults RunTests(const std::string& data_path,
                                 const std::string& mapping_path,
                                 double sample_part);
 
  private:
-  Network network_;
+  BasicNetwork<T, Master> network_;
 };
 
+using Controller = BasicController<double>;
+
 }  // namespace s21
 
 #endif  // CPP7_MLP_CONTROLLER_CONTROLLER_H_
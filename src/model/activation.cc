@@ -0,0 +1,109 @@
+#include "activation.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace s21 {
+namespace {
+template <class K, class T>
+void AddBiasesAndApply(size_t rows, size_t cols, const T* biases, T* values) {
+  if (cols == 1) return kernels::BiasMap<K>(rows, biases, 1, values);
+  for (size_t row = 0; row < rows; ++row)
+    kernels::BiasMap<K>(cols, biases + row, 0, values + row * cols);
+}
+}  // namespace
+
+bool NetworkFunctions::operator==(
+    const NetworkFunctions& other) const noexcept {
+  return activation == other.activation && loss == other.loss;
+}
+
+bool NetworkFunctions::operator!=(
+    const NetworkFunctions& other) const noexcept {
+  return !(*this == other);
+}
+
+template <class T>
+void NetworkFunctions::ActivateHidden(size_t rows, size_t cols,
+                                      const T* biases, T* values) const {
+  Dispatch(activation, [=](auto policy) {
+    using Kernel = typename decltype(policy)::Kernel;
+    AddBiasesAndApply<Kernel>(rows, cols, biases, values);
+  });
+}
+
+template <class T>
+void NetworkFunctions::ActivateOutput(size_t rows, size_t cols,
+                                      const T* biases, T* values) const {
+  if (loss == LossFunction::kCrossEntropy)
+    kernels::BiasSoftmax(rows, cols, biases, values);
+  else
+    AddBiasesAndApply<kernels::SigmoidKernel>(rows, cols, biases, values);
+}
+
+template <class T>
+void NetworkFunctions::ApplyHiddenDerivative(size_t n, const T* values,
+                                             T* deltas) const {
+  Dispatch(activation, [=](auto policy) {
+    for (size_t i = 0; i < n; ++i)
+      deltas[i] *= decltype(policy)::Derivative(values[i]);
+  });
+}
+
+// Softmax with the cross-entropy has the gradient outputs - expected; the
+// sigmoid with the mean squared error additionally the sigmoid derivative.
+template <class T>
+void NetworkFunctions::ComputeOutputDeltas(size_t rows, size_t cols,
+                                           const T* outputs,
+                                           const size_t* expected_classes,
+                                           T* deltas) const {
+  for (size_t row = 0; row < rows; ++row)
+    for (size_t col = 0; col < cols; ++col) {
+      T value = outputs[row * cols + col];
+      T delta = value;
+      if (row == expected_classes[col]) delta -= T(1);
+      if (loss == LossFunction::kMeanSquaredError)
+        delta *= SigmoidActivation::Derivative(value);
+      deltas[row * cols + col] = delta;
+    }
+}
+
+template <class T>
+double NetworkFunctions::GetLoss(size_t rows, size_t cols, const T* outputs,
+                                 size_t col, size_t expected_class) const {
+  if (loss == LossFunction::kCrossEntropy)
+    return -std::log(std::max<double>(outputs[expected_class * cols + col],
+                                      1e-300));
+  double sum = 0;
+  for (size_t row = 0; row < rows; ++row) {
+    double value = outputs[row * cols + col];
+    double exp_res = row == expected_class ? 1.0 : 0.0;
+    sum += (exp_res - value) * (exp_res - value);
+  }
+  return sum / 2.0;
+}
+
+// He initialization for the rectifiers, Glorot for everything else.
+double NetworkFunctions::GetInitRange(size_t inputs, size_t outputs,
+                                      bool output_layer) const {
+  if (!output_layer && (activation == ActivationFunction::kRelu ||
+                        activation == ActivationFunction::kLeakyRelu))
+    return std::sqrt(6.0 / inputs);
+  return std::sqrt(6.0) / std::sqrt(inputs + outputs);
+}
+
+#define S21_INSTANTIATE_NETWORK_FUNCTIONS(T)                               \
+  template void NetworkFunctions::ActivateHidden(size_t, size_t, const T*, \
+                                                 T*) const;                \
+  template void NetworkFunctions::ActivateOutput(size_t, size_t, const T*, \
+                                                 T*) const;                \
+  template void NetworkFunctions::ApplyHiddenDerivative(size_t, const T*,  \
+                                                        T*) const;         \
+  template void NetworkFunctions::ComputeOutputDeltas(                     \
+      size_t, size_t, const T*, const size_t*, T*) const;                  \
+  template double NetworkFunctions::GetLoss(size_t, size_t, const T*,      \
+                                            size_t, size_t) const;
+
+S21_INSTANTIATE_NETWORK_FUNCTIONS(float)
+S21_INSTANTIATE_NETWORK_FUNCTIONS(double)
+}  // namespace s21
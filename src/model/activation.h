@@ -0,0 +1,106 @@
+#ifndef CPP7_MLP_MODEL_ACTIVATION_H_
+#define CPP7_MLP_MODEL_ACTIVATION_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "kernels.h"
+
+namespace s21 {
+enum class ActivationFunction : uint8_t {
+  kSigmoid = 0,
+  kRelu = 1,
+  kLeakyRelu = 2,
+  kTanh = 3
+};
+
+enum class LossFunction : uint8_t { kMeanSquaredError = 0, kCrossEntropy = 1 };
+
+// Activation policies. Derivatives take the activation output, which is
+// what the backward pass keeps.
+struct SigmoidActivation {
+  using Kernel = kernels::SigmoidKernel;
+  template <class T>
+  static T Derivative(T y) {
+    return y * (T(1) - y);
+  }
+};
+
+struct ReluActivation {
+  using Kernel = kernels::ReluKernel;
+  template <class T>
+  static T Derivative(T y) {
+    return y > T(0) ? T(1) : T(0);
+  }
+};
+
+struct LeakyReluActivation {
+  using Kernel = kernels::LeakyReluKernel;
+  template <class T>
+  static T Derivative(T y) {
+    return y > T(0) ? T(1) : T(kernels::LeakyReluKernel::kSlope);
+  }
+};
+
+struct TanhActivation {
+  using Kernel = kernels::TanhKernel;
+  template <class T>
+  static T Derivative(T y) {
+    return T(1) - y * y;
+  }
+};
+
+// Functions a network is trained with. Hidden layers use activation. The
+// output layer is a sigmoid trained on the mean squared error or a softmax
+// trained on the cross-entropy. Every call dispatches once on the runtime
+// choice to loops compiled for the concrete policy.
+//
+// Blocks are rows x cols, one column per sample, of float or double.
+// Expected classes are indices of output neurons.
+struct NetworkFunctions {
+  ActivationFunction activation = ActivationFunction::kSigmoid;
+  LossFunction loss = LossFunction::kMeanSquaredError;
+
+  bool operator==(const NetworkFunctions& other) const noexcept;
+  bool operator!=(const NetworkFunctions& other) const noexcept;
+
+  template <class T>
+  void ActivateHidden(size_t rows, size_t cols, const T* biases,
+                      T* values) const;
+  template <class T>
+  void ActivateOutput(size_t rows, size_t cols, const T* biases,
+                      T* values) const;
+  // deltas[i] *= activation'(values[i]) over n hidden neurons.
+  template <class T>
+  void ApplyHiddenDerivative(size_t n, const T* values, T* deltas) const;
+  // Gradient of the loss with respect to the output layer sums.
+  template <class T>
+  void ComputeOutputDeltas(size_t rows, size_t cols, const T* outputs,
+                           const size_t* expected_classes, T* deltas) const;
+  // Loss of the sample in column col.
+  template <class T>
+  double GetLoss(size_t rows, size_t cols, const T* outputs, size_t col,
+                 size_t expected_class) const;
+  // Half-width of the uniform weight initialization of a layer.
+  double GetInitRange(size_t inputs, size_t outputs, bool output_layer) const;
+
+  template <class F>
+  static void Dispatch(ActivationFunction activation, F&& body);
+};
+
+template <class F>
+void NetworkFunctions::Dispatch(ActivationFunction activation, F&& body) {
+  switch (activation) {
+    case ActivationFunction::kRelu:
+      return body(ReluActivation());
+    case ActivationFunction::kLeakyRelu:
+      return body(LeakyReluActivation());
+    case ActivationFunction::kTanh:
+      return body(TanhActivation());
+    default:
+      return body(SigmoidActivation());
+  }
+}
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_ACTIVATION_H_
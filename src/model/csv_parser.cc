@@ -0,0 +1,209 @@
+#include "csv_parser.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "mapped_file.h"
+
+#if defined(__AVX512BW__) || defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+CsvParser::LetterTable::LetterTable(const Emnist::Mapping& mapping) {
+  for (const auto& entry : mapping) {
+    lower_case[entry.first] = entry.second.second;
+    upper_case[entry.first] = entry.second.first;
+  }
+}
+
+SampleStore CsvParser::Parse(const std::string& path_dataset,
+                             const Emnist::Mapping& mapping,
+                             ThreadPool& thread_pool,
+                             std::vector<char>* upper_case_letters) {
+  MappedFile file(path_dataset);
+  const char* data = file.GetData();
+  const char* data_end = data + file.GetSize();
+
+  size_t chunks_count = std::max(
+      std::min(thread_pool.GetThreadsCount() * kChunksPerThread,
+               file.GetSize() / kMinChunkSize),
+      size_t(1));
+  std::vector<Chunk> chunks;
+  chunks.reserve(chunks_count);
+  const char* begin = data;
+  for (size_t chunk = 1; chunk <= chunks_count && begin < data_end; ++chunk) {
+    const char* end = data + file.GetSize() * chunk / chunks_count;
+    if (end < begin) end = begin;
+    const char* newline =
+        static_cast<const char*>(std::memchr(end, '\n', data_end - end));
+    end = newline ? newline + 1 : data_end;
+    chunks.push_back({begin, end, 0, 0, 0, 0});
+    begin = end;
+  }
+
+  thread_pool.Run(chunks.size(),
+                  [&chunks](size_t chunk) { CountLines(chunks[chunk]); });
+  size_t samples_count = 0;
+  size_t lines_count = 0;
+  for (auto& chunk : chunks) {
+    chunk.first_sample = samples_count;
+    chunk.first_line = lines_count + 1;
+    samples_count += chunk.samples_count;
+    lines_count += chunk.lines_count;
+  }
+
+  LetterTable letters(mapping);
+  SampleStore::PixelBuffer pixels(samples_count * Emnist::kImageSize);
+  std::vector<char> labels(samples_count);
+  std::vector<char> upper_labels(upper_case_letters ? samples_count : 0);
+  char* upper_data = upper_case_letters ? upper_labels.data() : nullptr;
+  thread_pool.Run(chunks.size(), [&](size_t chunk) {
+    ParseChunk(chunks[chunk], letters, pixels.data(), labels.data(),
+               upper_data);
+  });
+
+  size_t valid = 0;
+  for (size_t sample = 0; sample < samples_count; ++sample) {
+    if (labels[sample] == 0) continue;
+    if (valid != sample) {
+      labels[valid] = labels[sample];
+      if (upper_data) upper_data[valid] = upper_data[sample];
+      std::memmove(pixels.data() + valid * Emnist::kImageSize,
+                   pixels.data() + sample * Emnist::kImageSize,
+                   Emnist::kImageSize);
+    }
+    ++valid;
+  }
+  labels.resize(valid);
+  pixels.resize(valid * Emnist::kImageSize);
+  if (upper_case_letters) {
+    upper_labels.resize(valid);
+    *upper_case_letters = std::move(upper_labels);
+  }
+  return SampleStore(std::move(pixels), std::move(labels), Emnist::kImageSize);
+}
+
+char CsvParser::ParseLine(const char* line, const char* line_end,
+                          size_t line_number, const LetterTable& letters,
+                          uint8_t* image, char* upper_case_letter) {
+  const char* field = line;
+  size_t index = 0;
+  unsigned key = 0;
+  for (const char* block = line; block < line_end; block += 64) {
+    uint64_t mask;
+    if (line_end - block >= 64) {
+      mask = CommaMask(block);
+    } else {
+      mask = 0;
+      for (const char* c = block; c < line_end; ++c)
+        if (*c == ',') mask |= uint64_t(1) << (c - block);
+    }
+    while (mask) {
+      const char* comma = block + __builtin_ctzll(mask);
+      mask &= mask - 1;
+      if (index == 0)
+        key = ParseNumber(field, comma, UINT8_MAX, line_number);
+      else if (index <= Emnist::kImageSize)
+        image[index - 1] = ParseNumber(field, comma, UINT8_MAX, line_number);
+      ++index;
+      field = comma + 1;
+    }
+  }
+  if (index == 0)
+    key = ParseNumber(field, line_end, UINT8_MAX, line_number);
+  else if (index <= Emnist::kImageSize)
+    image[index - 1] = ParseNumber(field, line_end, UINT8_MAX, line_number);
+
+  if (upper_case_letter) *upper_case_letter = letters.upper_case[key];
+  return letters.lower_case[key];
+}
+
+const char* CsvParser::NextLine(const char* begin, const char* end,
+                                const char*& line_end) {
+  const char* newline =
+      static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+  line_end = newline ? newline : end;
+  const char* next = newline ? newline + 1 : end;
+  if (line_end > begin && line_end[-1] == '\r') --line_end;
+  return next;
+}
+
+void CsvParser::CountLines(Chunk& chunk) {
+  const char* line = chunk.begin;
+  const char* line_end;
+  while (line < chunk.end) {
+    const char* next = NextLine(line, chunk.end, line_end);
+    if (line_end != line) ++chunk.samples_count;
+    ++chunk.lines_count;
+    line = next;
+  }
+}
+
+void CsvParser::ParseChunk(const Chunk& chunk, const LetterTable& letters,
+                           uint8_t* pixels, char* labels,
+                           char* upper_case_labels) {
+  size_t sample = chunk.first_sample;
+  size_t line_number = chunk.first_line;
+  const char* line = chunk.begin;
+  const char* line_end;
+  for (; line < chunk.end; ++line_number) {
+    const char* next = NextLine(line, chunk.end, line_end);
+    if (line_end != line) {
+      labels[sample] = ParseLine(
+          line, line_end, line_number, letters,
+          pixels + sample * Emnist::kImageSize,
+          upper_case_labels ? upper_case_labels + sample : nullptr);
+      ++sample;
+    }
+    line = next;
+  }
+}
+
+uint64_t CsvParser::CommaMask(const char* block) {
+#if defined(__AVX512BW__)
+  return _mm512_cmpeq_epi8_mask(_mm512_loadu_si512(block),
+                                _mm512_set1_epi8(','));
+#elif defined(__AVX2__)
+  __m256i comma = _mm256_set1_epi8(',');
+  uint32_t low = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block)), comma));
+  uint32_t high = _mm256_movemask_epi8(_mm256_cmpeq_epi8(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32)),
+      comma));
+  return uint64_t(high) << 32 | low;
+#elif defined(__SSE2__)
+  __m128i comma = _mm_set1_epi8(',');
+  uint64_t mask = 0;
+  for (size_t part = 0; part < 4; ++part)
+    mask |= uint64_t(static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(block + part * 16)),
+                comma))))
+            << (part * 16);
+  return mask;
+#else
+  uint64_t mask = 0;
+  for (size_t i = 0; i < 64; ++i)
+    if (block[i] == ',') mask |= uint64_t(1) << i;
+  return mask;
+#endif
+}
+
+unsigned CsvParser::ParseNumber(const char* begin, const char* end,
+                                unsigned max_value, size_t line_number) {
+  unsigned value = 0;
+  bool valid = begin < end;
+  for (; begin < end && valid; ++begin) {
+    valid = *begin >= '0' && *begin <= '9';
+    value = value * 10 + (*begin - '0');
+    valid = valid && value <= max_value;
+  }
+  if (!valid)
+    throw std::runtime_error("Invalid number in line " +
+                             std::to_string(line_number));
+  return value;
+}
+}  // namespace s21
@@ -0,0 +1,70 @@
+#ifndef CPP7_MLP_MODEL_CSV_PARSER_H_
+#define CPP7_MLP_MODEL_CSV_PARSER_H_
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "emnist.h"
+#include "sample_store.h"
+#include "thread_pool.h"
+
+namespace s21 {
+// Parallel parser of EMNIST CSV files. The file is memory mapped and split
+// into line-aligned chunks. A first pass counts the lines of every chunk so
+// that each sample gets its final slot, a second pass parses the chunks on
+// the thread pool straight into one preallocated pixel buffer. Field
+// delimiters are located 64 bytes at a time with SIMD compares.
+class CsvParser {
+ public:
+  // Letters of every label key of a mapping, zero for keys it lacks.
+  struct LetterTable {
+    LetterTable() = default;
+    explicit LetterTable(const Emnist::Mapping& mapping);
+
+    std::array<char, 256> lower_case{};
+    std::array<char, 256> upper_case{};
+  };
+
+  // Fills upper_case_letters, when given, with the upper-case label of
+  // every sample of the returned store.
+  static SampleStore Parse(const std::string& path_dataset,
+                           const Emnist::Mapping& mapping,
+                           ThreadPool& thread_pool,
+                           std::vector<char>* upper_case_letters = nullptr);
+  // Parses the record between line and line_end, a label key followed by
+  // the pixels, into image and returns the lower-case letter of the key,
+  // zero for keys the table lacks. Fields that are not decimal numbers in
+  // range throw an error naming line_number.
+  static char ParseLine(const char* line, const char* line_end,
+                        size_t line_number, const LetterTable& letters,
+                        uint8_t* image, char* upper_case_letter = nullptr);
+
+ private:
+  struct Chunk {
+    const char* begin;
+    const char* end;
+    size_t first_sample;
+    size_t samples_count;
+    size_t first_line;
+    size_t lines_count;
+  };
+
+  static constexpr size_t kChunksPerThread = 4;
+  static constexpr size_t kMinChunkSize = 1 << 20;
+
+  static const char* NextLine(const char* begin, const char* end,
+                              const char*& line_end);
+  // Counts the records (non-empty lines) and all lines of chunk.
+  static void CountLines(Chunk& chunk);
+  static void ParseChunk(const Chunk& chunk, const LetterTable& letters,
+                         uint8_t* pixels, char* labels,
+                         char* upper_case_labels);
+  static uint64_t CommaMask(const char* block);
+  static unsigned ParseNumber(const char* begin, const char* end,
+                              unsigned max_value, size_t line_number);
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_CSV_PARSER_H_
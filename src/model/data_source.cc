@@ -0,0 +1,205 @@
+#include "data_source.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace s21 {
+DataSource::~DataSource() {}
+
+std::unique_ptr<DataSource> DataSource::Open(const std::string& path_dataset,
+                                             const std::string& path_mapping) {
+  if (Emnist::IsBinaryDataset(path_dataset))
+    return std::make_unique<BinaryDataSource>(path_dataset);
+  return std::make_unique<CsvDataSource>(path_dataset, path_mapping);
+}
+
+CsvDataSource::CsvDataSource(const std::string& path_dataset,
+                             const std::string& path_mapping)
+    : file_stream_(path_dataset, std::ios::binary), buffer_(kBlockSize) {
+  Emnist::Mapping mapping;
+  if (!file_stream_.is_open() || !Emnist::LoadMapping(path_mapping, mapping))
+    throw std::runtime_error("Unable to open dataset or mapping file");
+  letters_ = CsvParser::LetterTable(mapping);
+}
+
+size_t CsvDataSource::Read(size_t count, SampleStore::PixelBuffer& pixels,
+                           std::vector<char>& labels) {
+  size_t read = 0;
+  while (read < count) {
+    const char* line = buffer_.data() + position_;
+    const char* end = buffer_.data() + size_;
+    const char* newline =
+        static_cast<const char*>(std::memchr(line, '\n', end - line));
+    if (!newline && Fill()) continue;
+    if (line == end) break;
+    const char* next = newline ? newline + 1 : end;
+    const char* line_end = newline ? newline : end;
+    if (line_end > line && line_end[-1] == '\r') --line_end;
+    ++line_number_;
+    position_ = next - buffer_.data();
+    if (line_end == line) continue;
+
+    size_t offset = pixels.size();
+    pixels.resize(offset + Emnist::kImageSize);
+    char label = CsvParser::ParseLine(line, line_end, line_number_, letters_,
+                                      pixels.data() + offset);
+    if (label) {
+      labels.push_back(label);
+      ++read;
+    } else {
+      pixels.resize(offset);
+    }
+  }
+  return read;
+}
+
+void CsvDataSource::Rewind() {
+  file_stream_.clear();
+  file_stream_.seekg(0);
+  position_ = 0;
+  size_ = 0;
+  line_number_ = 0;
+}
+
+bool CsvDataSource::Fill() {
+  if (!file_stream_) return false;
+  size_ -= position_;
+  std::memmove(buffer_.data(), buffer_.data() + position_, size_);
+  position_ = 0;
+  if (size_ == buffer_.size()) buffer_.resize(2 * buffer_.size());
+  file_stream_.read(buffer_.data() + size_, buffer_.size() - size_);
+  size_ += file_stream_.gcount();
+  return true;
+}
+
+BinaryDataSource::BinaryDataSource(const std::string& path_dataset)
+    : dataset_(path_dataset) {}
+
+size_t BinaryDataSource::Read(size_t count, SampleStore::PixelBuffer& pixels,
+                              std::vector<char>& labels) {
+  size_t read = std::min(count, dataset_.GetSize() - position_);
+  if (read == 0) return 0;
+  const uint8_t* begin = dataset_.GetPixels(position_);
+  pixels.insert(pixels.end(), begin, begin + read * dataset_.GetImageSize());
+  for (size_t sample = 0; sample < read; ++sample)
+    labels.push_back(dataset_.GetLowerCaseLetter(position_ + sample));
+  position_ += read;
+  return read;
+}
+
+void BinaryDataSource::Rewind() { position_ = 0; }
+
+SampleStream::SampleStream(DataSource& source, size_t shuffle_buffer_size,
+                           size_t block_size,
+                           std::mt19937::result_type seed)
+    : source_(source),
+      shuffle_buffer_size_(std::max(shuffle_buffer_size, block_size)),
+      block_size_(block_size),
+      random_gen_(seed) {
+  if (block_size == 0) throw std::runtime_error("Invalid block size");
+  source_.Rewind();
+  producer_ = std::thread(&SampleStream::Produce, this);
+}
+
+SampleStream::~SampleStream() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  not_full_.notify_all();
+  producer_.join();
+}
+
+bool SampleStream::Next(SampleStore& block) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_empty_.wait(lock, [this] { return !queue_.empty() || finished_; });
+  if (queue_.empty()) {
+    if (error_) std::rethrow_exception(error_);
+    return false;
+  }
+  block = std::move(queue_.front());
+  queue_.pop_front();
+  not_full_.notify_one();
+  return true;
+}
+
+void SampleStream::Produce() {
+  try {
+    SampleStore::PixelBuffer buffer_pixels;
+    std::vector<char> buffer_labels;
+    SampleStore::PixelBuffer chunk_pixels;
+    std::vector<char> chunk_labels;
+    SampleStore::PixelBuffer block_pixels;
+    std::vector<char> block_labels;
+    buffer_pixels.reserve(shuffle_buffer_size_ * image_size_);
+    buffer_labels.reserve(shuffle_buffer_size_);
+
+    size_t read;
+    do {
+      chunk_pixels.clear();
+      chunk_labels.clear();
+      read = source_.Read(kReadChunkSize, chunk_pixels, chunk_labels);
+      for (size_t sample = 0; sample < read; ++sample) {
+        const uint8_t* pixels = chunk_pixels.data() + sample * image_size_;
+        if (buffer_labels.size() < shuffle_buffer_size_) {
+          buffer_pixels.insert(buffer_pixels.end(), pixels,
+                               pixels + image_size_);
+          buffer_labels.push_back(chunk_labels[sample]);
+          continue;
+        }
+        std::uniform_int_distribution<size_t> dist(0, shuffle_buffer_size_ - 1);
+        size_t slot = dist(random_gen_);
+        uint8_t* slot_pixels = buffer_pixels.data() + slot * image_size_;
+        block_pixels.insert(block_pixels.end(), slot_pixels,
+                            slot_pixels + image_size_);
+        block_labels.push_back(buffer_labels[slot]);
+        std::copy(pixels, pixels + image_size_, slot_pixels);
+        buffer_labels[slot] = chunk_labels[sample];
+        if (block_labels.size() == block_size_ &&
+            !Push(block_pixels, block_labels))
+          return;
+      }
+    } while (read != 0);
+
+    std::vector<size_t> order(buffer_labels.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::shuffle(order.begin(), order.end(), random_gen_);
+    for (size_t slot : order) {
+      const uint8_t* slot_pixels = buffer_pixels.data() + slot * image_size_;
+      block_pixels.insert(block_pixels.end(), slot_pixels,
+                          slot_pixels + image_size_);
+      block_labels.push_back(buffer_labels[slot]);
+      if (block_labels.size() == block_size_ &&
+          !Push(block_pixels, block_labels))
+        return;
+    }
+    if (!block_labels.empty()) Push(block_pixels, block_labels);
+  } catch (...) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    error_ = std::current_exception();
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finished_ = true;
+  }
+  not_empty_.notify_all();
+}
+
+bool SampleStream::Push(SampleStore::PixelBuffer& pixels,
+                        std::vector<char>& labels) {
+  SampleStore block(std::move(pixels), std::move(labels), image_size_);
+  pixels = SampleStore::PixelBuffer();
+  labels = std::vector<char>();
+  pixels.reserve(block_size_ * image_size_);
+  labels.reserve(block_size_);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  not_full_.wait(lock,
+                 [this] { return queue_.size() < kQueueCapacity || stop_; });
+  if (stop_) return false;
+  queue_.push_back(std::move(block));
+  not_empty_.notify_one();
+  return true;
+}
+}  // namespace s21
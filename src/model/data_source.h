@@ -0,0 +1,116 @@
+#ifndef CPP7_MLP_MODEL_DATA_SOURCE_H_
+#define CPP7_MLP_MODEL_DATA_SOURCE_H_
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "csv_parser.h"
+#include "emnist.h"
+#include "sample_store.h"
+
+namespace s21 {
+// Sequential reader of labelled images that never holds more than the
+// requested chunk in memory.
+class DataSource {
+ public:
+  virtual ~DataSource();
+
+  // Appends up to count samples to pixels and labels, returns the number of
+  // samples read. Zero means the end of the data.
+  virtual size_t Read(size_t count, SampleStore::PixelBuffer& pixels,
+                      std::vector<char>& labels) = 0;
+  virtual void Rewind() = 0;
+
+  static std::unique_ptr<DataSource> Open(const std::string& path_dataset,
+                                          const std::string& path_mapping);
+};
+
+// Reads the file in blocks of kBlockSize bytes (or one longer line) and
+// parses whole lines out of them with CsvParser::ParseLine.
+class CsvDataSource : public DataSource {
+ public:
+  CsvDataSource(const std::string& path_dataset,
+                const std::string& path_mapping);
+
+  size_t Read(size_t count, SampleStore::PixelBuffer& pixels,
+              std::vector<char>& labels) override;
+  void Rewind() override;
+
+ private:
+  static constexpr size_t kBlockSize = 1 << 20;
+
+  // Moves the unparsed bytes to the front of buffer_ and appends the next
+  // bytes of the file. Returns false at the end of the file.
+  bool Fill();
+
+  std::ifstream file_stream_;
+  CsvParser::LetterTable letters_;
+  std::vector<char> buffer_;
+  size_t position_ = 0;
+  size_t size_ = 0;
+  size_t line_number_ = 0;
+};
+
+class BinaryDataSource : public DataSource {
+ public:
+  explicit BinaryDataSource(const std::string& path_dataset);
+
+  size_t Read(size_t count, SampleStore::PixelBuffer& pixels,
+              std::vector<char>& labels) override;
+  void Rewind() override;
+
+ private:
+  Emnist::MappedDataset dataset_;
+  size_t position_ = 0;
+};
+
+// Reads a DataSource on a background thread, mixes the samples through a
+// bounded shuffle buffer and hands them out as blocks of block_size samples.
+// At most two blocks wait in the queue, so reading and parsing overlap with
+// training on the previous block.
+class SampleStream {
+ public:
+  SampleStream(DataSource& source, size_t shuffle_buffer_size,
+               size_t block_size, std::mt19937::result_type seed);
+  SampleStream(const SampleStream& other) = delete;
+  SampleStream(SampleStream&& other) = delete;
+  SampleStream& operator=(const SampleStream& other) = delete;
+  SampleStream& operator=(SampleStream&& other) = delete;
+  ~SampleStream();
+
+  // Waits for the next block, returns false when the source is exhausted.
+  bool Next(SampleStore& block);
+
+ private:
+  static constexpr size_t kQueueCapacity = 2;
+  static constexpr size_t kReadChunkSize = 4096;
+
+  void Produce();
+  bool Push(SampleStore::PixelBuffer& pixels, std::vector<char>& labels);
+
+  DataSource& source_;
+  size_t shuffle_buffer_size_;
+  size_t block_size_;
+  std::mt19937 random_gen_;
+  size_t image_size_ = Emnist::kImageSize;
+
+  std::thread producer_;
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<SampleStore> queue_;
+  bool finished_ = false;
+  bool stop_ = false;
+  std::exception_ptr error_;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_DATA_SOURCE_H_
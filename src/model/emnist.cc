@@ -1,51 +1,164 @@
 #include "emnist.h"
 
+#include <algorithm>
+#include <sstream>
+
+#include "csv_parser.h"
+
 namespace s21 {
-std::vector<Emnist::Dataset> Emnist::LoadDataset(
-    const std::string& pathDataset, const std::string& pathMapping) {
-  std::map<uint8_t, std::pair<char, char>> mapping;
-  std::vector<Dataset> dataset;
-  std::ifstream fDataset;
-  std::ifstream fMapping;
+SampleStore Emnist::LoadDataset(const std::string& pathDataset,
+                                const std::string& pathMapping) {
+  ThreadPool thread_pool;
+  return LoadDataset(pathDataset, pathMapping, thread_pool);
+}
 
-  fDataset.open(pathDataset);
-  fMapping.open(pathMapping);
-  if (fDataset.is_open() && fMapping.is_open()) {
-    std::string line;
-    while (std::getline(fMapping, line).good()) {
-      uint8_t key =
-          std::atoi(std::strtok(const_cast<char*>(line.c_str()), " "));
-      char upperCaseLetter = std::atoi(std::strtok(nullptr, " "));
-      char lowerCaseLetter = std::atoi(std::strtok(nullptr, " "));
-      mapping[key] = {upperCaseLetter, lowerCaseLetter};
-    }
-
-    Dataset data;
-    while (std::getline(fDataset, line).good()) {
-      uint8_t key =
-          std::atoi(std::strtok(const_cast<char*>(line.c_str()), ","));
-      auto it = mapping.find(key);
-      if (it != mapping.end()) {
-        char* next;
-        int count = 0;
-        data.upperCaseLetter = it->second.first;
-        data.lowerCaseLetter = it->second.second;
-        while ((next = std::strtok(nullptr, ","))) {
-          data.imageData(count++, 0) = std::atoi(next) / 255.0;
-        }
-      }
-      dataset.push_back(data);
-    }
+SampleStore Emnist::LoadDataset(const std::string& pathDataset,
+                                const std::string& pathMapping,
+                                ThreadPool& thread_pool) {
+  if (IsBinaryDataset(pathDataset)) {
+    auto mapped = std::make_shared<const MappedDataset>(pathDataset);
+    std::vector<char> labels;
+    labels.reserve(mapped->GetSize());
+    for (size_t sample = 0; sample < mapped->GetSize(); ++sample)
+      labels.push_back(mapped->GetLowerCaseLetter(sample));
+    const uint8_t* pixels = mapped->GetPixels(0);
+    return SampleStore(std::move(mapped), pixels, std::move(labels),
+                       kImageSize);
   }
 
-  if (fDataset.is_open()) {
-    fDataset.close();
-  }
+  Mapping mapping;
+  std::ifstream fDataset(pathDataset);
+  if (!fDataset.is_open() || !LoadMapping(pathMapping, mapping))
+    return SampleStore();
+  fDataset.close();
+  return CsvParser::Parse(pathDataset, mapping, thread_pool);
+}
+
+void Emnist::ConvertToBinary(const std::string& path_dataset,
+                             const std::string& path_mapping,
+                             const std::string& path_binary) {
+  ThreadPool thread_pool(std::max(std::thread::hardware_concurrency(), 1u));
+  ConvertToBinary(path_dataset, path_mapping, path_binary, thread_pool);
+}
+
+void Emnist::ConvertToBinary(const std::string& path_dataset,
+                             const std::string& path_mapping,
+                             const std::string& path_binary,
+                             ThreadPool& thread_pool) {
+  Mapping mapping;
+  if (!LoadMapping(path_mapping, mapping))
+    throw std::runtime_error("Unable to open mapping file " + path_mapping);
+  std::vector<char> upper_case_letters;
+  auto samples = CsvParser::Parse(path_dataset, mapping, thread_pool,
+                                  &upper_case_letters);
+  std::vector<BinaryLabel> labels;
+  labels.reserve(samples.GetSize());
+  for (size_t sample = 0; sample < samples.GetSize(); ++sample)
+    labels.push_back(
+        {upper_case_letters[sample], samples.GetLowerCaseLetter(sample)});
+
+  BinaryHeader header;
+  std::memcpy(header.magic, kBinaryMagic, sizeof(header.magic));
+  header.version = kBinaryVersion;
+  header.image_size = kImageSize;
+  header.samples_count = labels.size();
+  header.labels_offset = sizeof(BinaryHeader);
+  header.pixels_offset = header.labels_offset +
+                         labels.size() * sizeof(BinaryLabel) +
+                         kBinaryAlignment - 1;
+  header.pixels_offset -= header.pixels_offset % kBinaryAlignment;
+
+  std::ofstream file_stream(path_binary, std::ios::binary);
+  if (!file_stream.is_open())
+    throw std::runtime_error("Unable to create file " + path_binary);
+  file_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file_stream.write(reinterpret_cast<const char*>(labels.data()),
+                    labels.size() * sizeof(BinaryLabel));
+  std::vector<char> padding(header.pixels_offset - header.labels_offset -
+                            labels.size() * sizeof(BinaryLabel));
+  file_stream.write(padding.data(), padding.size());
+  for (size_t sample = 0; sample < samples.GetSize(); ++sample)
+    file_stream.write(reinterpret_cast<const char*>(samples.GetPixels(sample)),
+                      kImageSize);
+  if (!file_stream.good())
+    throw std::runtime_error("Unable to write file " + path_binary);
+}
+
+bool Emnist::IsBinaryDataset(const std::string& path) {
+  std::ifstream file_stream(path, std::ios::binary);
+  char magic[sizeof(kBinaryMagic)];
+  if (!file_stream.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, kBinaryMagic, sizeof(magic)) == 0;
+}
+
+bool Emnist::LoadMapping(const std::string& path_mapping, Mapping& mapping) {
+  std::ifstream fMapping;
+  fMapping.open(path_mapping);
+  if (!fMapping.is_open()) return false;
 
-  if (fMapping.is_open()) {
-    fMapping.close();
+  std::string line;
+  while (std::getline(fMapping, line)) {
+    std::istringstream fields(line);
+    unsigned key, upperCaseLetter, lowerCaseLetter;
+    if (!(fields >> key >> upperCaseLetter) || key > UINT8_MAX) continue;
+    if (!(fields >> lowerCaseLetter)) lowerCaseLetter = upperCaseLetter;
+    mapping[key] = {static_cast<char>(upperCaseLetter),
+                    static_cast<char>(lowerCaseLetter)};
   }
+  return true;
+}
+
+std::vector<char> Emnist::GetLabels(const Mapping& mapping) {
+  std::vector<char> labels;
+  for (const auto& entry : mapping)
+    if (std::find(labels.begin(), labels.end(), entry.second.second) ==
+        labels.end())
+      labels.push_back(entry.second.second);
+  return labels;
+}
+
+std::vector<char> Emnist::GetDefaultLabels(size_t classes_count) {
+  std::vector<char> labels(classes_count, '?');
+  for (size_t i = 0; i < classes_count && i < 26; ++i) labels[i] = 'a' + i;
+  return labels;
+}
+
+Emnist::MappedDataset::MappedDataset(const std::string& path) : file_(path) {
+  header_ = reinterpret_cast<const BinaryHeader*>(file_.GetData());
+  if (file_.GetSize() < sizeof(BinaryHeader) ||
+      std::memcmp(header_->magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0)
+    throw std::runtime_error("File is not a binary dataset");
+  if (header_->version != kBinaryVersion || header_->image_size != kImageSize)
+    throw std::runtime_error("Unsupported binary dataset version");
+  if (header_->labels_offset +
+              header_->samples_count * sizeof(BinaryLabel) >
+          file_.GetSize() ||
+      header_->pixels_offset + header_->samples_count * kImageSize >
+          file_.GetSize())
+    throw std::runtime_error("Binary dataset is truncated");
+  labels_ = reinterpret_cast<const BinaryLabel*>(file_.GetData() +
+                                                 header_->labels_offset);
+  pixels_ = reinterpret_cast<const uint8_t*>(file_.GetData() +
+                                             header_->pixels_offset);
+}
+
+size_t Emnist::MappedDataset::GetSize() const noexcept {
+  return header_->samples_count;
+}
+
+size_t Emnist::MappedDataset::GetImageSize() const noexcept {
+  return header_->image_size;
+}
+
+const uint8_t* Emnist::MappedDataset::GetPixels(size_t index) const noexcept {
+  return pixels_ + index * header_->image_size;
+}
+
+char Emnist::MappedDataset::GetUpperCaseLetter(size_t index) const noexcept {
+  return labels_[index].upper_case_letter;
+}
 
-  return dataset;
+char Emnist::MappedDataset::GetLowerCaseLetter(size_t index) const noexcept {
+  return labels_[index].lower_case_letter;
 }
-}  // namespace s21
\ No newline at end of file
+}  // namespace s21
@@ -8,21 +8,77 @@
 #include <string>
 #include <vector>
 
-#include "s21_matrix.h"
+#include "mapped_file.h"
+#include "sample_store.h"
+#include "thread_pool.h"
 
 namespace s21 {
 class Emnist {
  public:
-  struct Dataset {
+  // Layout of a binary dataset file: the header, samples_count labels at
+  // labels_offset and samples_count * image_size pixels at pixels_offset.
+  // The pixel block starts on a kBinaryAlignment boundary.
+  struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t image_size;
+    uint64_t samples_count;
+    uint64_t labels_offset;
+    uint64_t pixels_offset;
+  };
+
+  struct BinaryLabel {
+    char upper_case_letter;
+    char lower_case_letter;
+  };
+
+  // Zero-copy view of a binary dataset file.
+  class MappedDataset {
    public:
-    char upperCaseLetter;
-    char lowerCaseLetter;
-    S21Matrix<double> imageData = S21Matrix<double>(784, 1);
+    explicit MappedDataset(const std::string& path);
+
+    size_t GetSize() const noexcept;
+    size_t GetImageSize() const noexcept;
+    const uint8_t* GetPixels(size_t index) const noexcept;
+    char GetUpperCaseLetter(size_t index) const noexcept;
+    char GetLowerCaseLetter(size_t index) const noexcept;
+
+   private:
+    MappedFile file_;
+    const BinaryHeader* header_;
+    const BinaryLabel* labels_;
+    const uint8_t* pixels_;
   };
 
-  static std::vector<Dataset> LoadDataset(const std::string& pathDataset,
-                                          const std::string& pathMapping);
+  using Mapping = std::map<uint8_t, std::pair<char, char>>;
+
+  static constexpr char kBinaryMagic[8] = {'S', '2', '1', 'E',
+                                           'M', 'N', 'S', 'T'};
+  static constexpr uint32_t kBinaryVersion = 1;
+  static constexpr size_t kBinaryAlignment = 64;
+  static constexpr size_t kImageSize = 784;
+
+  static SampleStore LoadDataset(const std::string& pathDataset,
+                                 const std::string& pathMapping);
+  static SampleStore LoadDataset(const std::string& pathDataset,
+                                 const std::string& pathMapping,
+                                 ThreadPool& thread_pool);
+  static void ConvertToBinary(const std::string& path_dataset,
+                              const std::string& path_mapping,
+                              const std::string& path_binary);
+  static void ConvertToBinary(const std::string& path_dataset,
+                              const std::string& path_mapping,
+                              const std::string& path_binary,
+                              ThreadPool& thread_pool);
+  static bool IsBinaryDataset(const std::string& path);
+  // Lines hold a key with its upper- and lower-case letter codes, or, as in
+  // EMNIST balanced and byclass, a key with one code used for both.
+  static bool LoadMapping(const std::string& path_mapping, Mapping& mapping);
+  // Class labels of mapping in key order, every lower-case letter once.
+  static std::vector<char> GetLabels(const Mapping& mapping);
+  // Labels of EMNIST letters: 'a' + i for class i and '?' past 'z'.
+  static std::vector<char> GetDefaultLabels(size_t classes_count);
 };
 }  // namespace s21
 
-#endif  // CPP7_MLP_MODEL_EMNIST_H_
\ No newline at end of file
+#endif  // CPP7_MLP_MODEL_EMNIST_H_
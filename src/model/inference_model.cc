@@ -0,0 +1,155 @@
+#include "inference_model.h"
+
+namespace s21 {
+template <class T>
+InferenceModel<T>::InferenceModel(std::vector<S21Matrix<T>> weights,
+                                  std::vector<S21Matrix<T>> biases,
+                                  std::vector<char> labels,
+                                  NetworkFunctions functions,
+                                  bool static_engine)
+    : weights_(std::move(weights)),
+      biases_(std::move(biases)),
+      labels_(std::move(labels)),
+      functions_(functions) {
+  if (weights_.empty() || weights_.size() != biases_.size())
+    throw std::runtime_error("Weights do not match biases");
+  if (labels_.size() != GetOutputsCount())
+    throw std::runtime_error("Labels do not match the output layer");
+  if (static_engine)
+    static_engine_ = StaticEngine<T>::Create(weights_, biases_, functions_);
+}
+
+template <class T>
+size_t InferenceModel<T>::GetInputsCount() const noexcept {
+  return weights_.front().GetCols();
+}
+
+template <class T>
+size_t InferenceModel<T>::GetOutputsCount() const noexcept {
+  return weights_.back().GetRows();
+}
+
+template <class T>
+const NetworkFunctions& InferenceModel<T>::GetFunctions() const noexcept {
+  return functions_;
+}
+
+template <class T>
+bool InferenceModel<T>::UsesStaticEngine() const noexcept {
+  return static_cast<bool>(static_engine_);
+}
+
+template <class T>
+char InferenceModel<T>::GetLabel(size_t output) const noexcept {
+  return labels_[output];
+}
+
+template <class T>
+const S21Matrix<T>& InferenceModel<T>::FeedForward(
+    const S21Matrix<T>& images, Scratch& scratch) const {
+  if (images.GetRows() != GetInputsCount())
+    throw std::runtime_error("Image does not match the input layer");
+  scratch.activations.resize(weights_.size());
+  if (static_engine_ && images.GetCols() == 1) {
+    auto& output = scratch.activations.back();
+    if (output.GetRows() != GetOutputsCount() || output.GetCols() != 1)
+      output = S21Matrix<T>(GetOutputsCount(), 1);
+    static_engine_->FeedForward(images.Data(), output.Data());
+    return output;
+  }
+  const S21Matrix<T>* input = &images;
+  for (size_t layer = 0; layer < weights_.size(); ++layer) {
+    auto& output = scratch.activations[layer];
+    output = weights_[layer] * *input;
+    if (layer + 1 != weights_.size())
+      functions_.ActivateHidden(output.GetRows(), output.GetCols(),
+                                biases_[layer].Data(), output.Data());
+    else
+      functions_.ActivateOutput(output.GetRows(), output.GetCols(),
+                                biases_[layer].Data(), output.Data());
+    input = &output;
+  }
+  return scratch.activations.back();
+}
+
+template <class T>
+size_t InferenceModel<T>::Predict(const S21Matrix<T>& image) const {
+  return Predict(image, GetThreadScratch());
+}
+
+template <class T>
+size_t InferenceModel<T>::Predict(const S21Matrix<T>& image,
+                                  Scratch& scratch) const {
+  const auto& outputs = FeedForward(image, scratch);
+  size_t max_index = 0;
+  const T* values = outputs.Data();
+  for (size_t row = 1; row < outputs.GetRows(); ++row)
+    if (values[row] > values[max_index]) max_index = row;
+  return max_index;
+}
+
+template <class T>
+void InferenceModel<T>::PredictBatch(const S21Matrix<T>& images,
+                                     std::vector<size_t>& predictions) const {
+  const auto& outputs = FeedForward(images, GetThreadScratch());
+  for (size_t col = 0; col < outputs.GetCols(); ++col) {
+    size_t max_index = 0;
+    for (size_t row = 1; row < outputs.GetRows(); ++row)
+      if (outputs.UncheckedAt(row, col) > outputs.UncheckedAt(max_index, col))
+        max_index = row;
+    predictions.push_back(max_index);
+  }
+}
+
+template <class T>
+std::vector<InferenceModelBase::Classification>
+InferenceModel<T>::ClassifyBatch(const uint8_t* pixels, size_t images_count,
+                                 size_t top_k) const {
+  size_t inputs_count = GetInputsCount();
+  size_t outputs_count = GetOutputsCount();
+  top_k = std::min(top_k, outputs_count);
+  std::vector<Classification> result(images_count);
+  std::vector<size_t> order(outputs_count);
+  Scratch& scratch = GetThreadScratch();
+  for (size_t begin = 0; begin < images_count; begin += kClassifyBatchSize) {
+    size_t count = std::min(kClassifyBatchSize, images_count - begin);
+    if (scratch.images.GetRows() != inputs_count ||
+        scratch.images.GetCols() != count)
+      scratch.images = S21Matrix<T>(inputs_count, count);
+    T* images = scratch.images.Data();
+    for (size_t col = 0; col < count; ++col) {
+      const uint8_t* image = pixels + (begin + col) * inputs_count;
+      for (size_t row = 0; row < inputs_count; ++row)
+        images[row * count + col] = image[row] / T(255);
+    }
+
+    const auto& outputs = FeedForward(scratch.images, scratch);
+    for (size_t col = 0; col < count; ++col) {
+      double sum = 0;
+      for (size_t row = 0; row < outputs_count; ++row)
+        sum += outputs.UncheckedAt(row, col);
+      for (size_t row = 0; row < outputs_count; ++row) order[row] = row;
+      std::partial_sort(order.begin(), order.begin() + top_k, order.end(),
+                        [&outputs, col](size_t left, size_t right) {
+                          return outputs.UncheckedAt(left, col) >
+                                 outputs.UncheckedAt(right, col);
+                        });
+      auto& classification = result[begin + col];
+      classification.reserve(top_k);
+      for (size_t i = 0; i < top_k; ++i)
+        classification.push_back({labels_[order[i]],
+                                  outputs.UncheckedAt(order[i], col) / sum});
+    }
+  }
+  return result;
+}
+
+template <class T>
+typename InferenceModel<T>::Scratch& InferenceModel<T>::GetThreadScratch() {
+  thread_local Scratch scratch;
+  return scratch;
+}
+
+template class InferenceModel<float>;
+template class InferenceModel<double>;
+}  // namespace s21
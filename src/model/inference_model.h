@@ -0,0 +1,84 @@
+#ifndef CPP7_MLP_MODEL_INFERENCE_MODEL_H_
+#define CPP7_MLP_MODEL_INFERENCE_MODEL_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "activation.h"
+#include "s21_matrix.h"
+#include "static_network.h"
+
+namespace s21 {
+// Types shared by inference models of every precision.
+class InferenceModelBase {
+ public:
+  // Letter is the label of an output neuron and score its activation
+  // normalized over all output neurons.
+  struct Candidate {
+    char letter;
+    double score;
+  };
+  using Classification = std::vector<Candidate>;
+
+  static constexpr size_t kClassifyBatchSize = 256;
+};
+
+// Immutable snapshot of trained weights and biases of type T, float or
+// double, which is also the type the model computes in. Intermediate
+// activations live in a Scratch owned by the caller (or by the calling
+// thread), so one model can be shared by any number of threads.
+//
+// Single images go through a StaticEngine when static_engine is set and
+// the topology has a precompiled one.
+template <class T>
+class InferenceModel : public InferenceModelBase {
+ public:
+  struct Scratch {
+    S21Matrix<T> images;
+    std::vector<S21Matrix<T>> activations;
+  };
+
+  // labels holds the label of every output neuron.
+  InferenceModel(std::vector<S21Matrix<T>> weights,
+                 std::vector<S21Matrix<T>> biases, std::vector<char> labels,
+                 NetworkFunctions functions = {}, bool static_engine = true);
+  InferenceModel(const InferenceModel& other) = delete;
+  InferenceModel(InferenceModel&& other) = delete;
+  InferenceModel& operator=(const InferenceModel& other) = delete;
+  InferenceModel& operator=(InferenceModel&& other) = delete;
+
+  size_t GetInputsCount() const noexcept;
+  size_t GetOutputsCount() const noexcept;
+  const NetworkFunctions& GetFunctions() const noexcept;
+  bool UsesStaticEngine() const noexcept;
+  char GetLabel(size_t output) const noexcept;
+  // Takes one image per column and returns the output activations, one
+  // column per image. The result is stored in scratch.
+  const S21Matrix<T>& FeedForward(const S21Matrix<T>& images,
+                                  Scratch& scratch) const;
+  size_t Predict(const S21Matrix<T>& image) const;
+  size_t Predict(const S21Matrix<T>& image, Scratch& scratch) const;
+  void PredictBatch(const S21Matrix<T>& images,
+                    std::vector<size_t>& predictions) const;
+  // Classifies images_count images stored one after another as 8-bit
+  // pixels in dataset order and returns the top_k letters of each.
+  std::vector<Classification> ClassifyBatch(const uint8_t* pixels,
+                                            size_t images_count,
+                                            size_t top_k) const;
+
+ private:
+  static Scratch& GetThreadScratch();
+
+  const std::vector<S21Matrix<T>> weights_;
+  const std::vector<S21Matrix<T>> biases_;
+  const std::vector<char> labels_;
+  const NetworkFunctions functions_;
+  std::unique_ptr<const StaticEngine<T>> static_engine_;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_INFERENCE_MODEL_H_
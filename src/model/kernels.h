@@ -0,0 +1,537 @@
+#ifndef CPP7_MLP_MODEL_KERNELS_H_
+#define CPP7_MLP_MODEL_KERNELS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__FMA__))
+#include <immintrin.h>
+#endif
+
+namespace s21 {
+namespace kernels {
+
+// SIMD register abstraction. ScalarVec is the portable one-lane fallback,
+// specializations of Vec below map the same operations onto AVX2/AVX-512
+// depending on what the translation unit is compiled for.
+template <class T>
+struct ScalarVec {
+  using Type = T;
+  static constexpr size_t kWidth = 1;
+  static Type Load(const T* ptr) { return *ptr; }
+  static void Store(T* ptr, Type value) { *ptr = value; }
+  static Type Set1(T value) { return value; }
+  static Type Zero() { return T(); }
+  static Type Add(Type a, Type b) { return a + b; }
+  static Type Sub(Type a, Type b) { return a - b; }
+  static Type Mul(Type a, Type b) { return a * b; }
+  static Type Div(Type a, Type b) { return a / b; }
+  static Type Min(Type a, Type b) { return std::min(a, b); }
+  static Type Max(Type a, Type b) { return std::max(a, b); }
+  static Type FMAdd(Type a, Type b, Type c) { return a * b + c; }
+  static Type Round(Type a) { return std::nearbyint(a); }
+  // 2^n for an integral n within the normal exponent range.
+  static Type Pow2(Type n) { return std::ldexp(T(1), static_cast<int>(n)); }
+  static T Sum(Type value) { return value; }
+};
+
+template <class T>
+struct Vec : ScalarVec<T> {};
+
+#if defined(__AVX512F__)
+// The all-lanes maskz forms below avoid GCC 12 -Wuninitialized false
+// positives on the plain intrinsics, which start from an undefined vector.
+template <>
+struct Vec<double> {
+  using Type = __m512d;
+  static constexpr size_t kWidth = 8;
+  static Type Load(const double* ptr) { return _mm512_loadu_pd(ptr); }
+  static void Store(double* ptr, Type value) { _mm512_storeu_pd(ptr, value); }
+  static Type Set1(double value) { return _mm512_set1_pd(value); }
+  static Type Zero() { return _mm512_setzero_pd(); }
+  static Type Add(Type a, Type b) { return _mm512_add_pd(a, b); }
+  static Type Mul(Type a, Type b) { return _mm512_mul_pd(a, b); }
+  static Type Sub(Type a, Type b) { return _mm512_sub_pd(a, b); }
+  static Type Div(Type a, Type b) { return _mm512_div_pd(a, b); }
+  static Type Min(Type a, Type b) { return _mm512_maskz_min_pd(0xFF, a, b); }
+  static Type Max(Type a, Type b) { return _mm512_maskz_max_pd(0xFF, a, b); }
+  static Type Round(Type a) {
+    return _mm512_maskz_roundscale_pd(0xFF, a, _MM_FROUND_TO_NEAREST_INT);
+  }
+  static Type Pow2(Type n) {
+    __m512i exponent = _mm512_maskz_cvtepi32_epi64(
+        0xFF, _mm512_maskz_cvtpd_epi32(0xFF, n));
+    exponent = _mm512_add_epi64(exponent, _mm512_set1_epi64(1023));
+    return _mm512_castsi512_pd(_mm512_maskz_slli_epi64(0xFF, exponent, 52));
+  }
+  static Type FMAdd(Type a, Type b, Type c) { return _mm512_fmadd_pd(a, b, c); }
+  static double Sum(Type value) {
+    alignas(64) double lanes[kWidth];
+    _mm512_store_pd(lanes, value);
+    double sum = 0.0;
+    for (size_t i = 0; i < kWidth; ++i) sum += lanes[i];
+    return sum;
+  }
+};
+
+template <>
+struct Vec<float> {
+  using Type = __m512;
+  static constexpr size_t kWidth = 16;
+  static Type Load(const float* ptr) { return _mm512_loadu_ps(ptr); }
+  static void Store(float* ptr, Type value) { _mm512_storeu_ps(ptr, value); }
+  static Type Set1(float value) { return _mm512_set1_ps(value); }
+  static Type Zero() { return _mm512_setzero_ps(); }
+  static Type Add(Type a, Type b) { return _mm512_add_ps(a, b); }
+  static Type Mul(Type a, Type b) { return _mm512_mul_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm512_sub_ps(a, b); }
+  static Type Div(Type a, Type b) { return _mm512_div_ps(a, b); }
+  static Type Min(Type a, Type b) { return _mm512_maskz_min_ps(0xFFFF, a, b); }
+  static Type Max(Type a, Type b) { return _mm512_maskz_max_ps(0xFFFF, a, b); }
+  static Type Round(Type a) {
+    return _mm512_maskz_roundscale_ps(0xFFFF, a, _MM_FROUND_TO_NEAREST_INT);
+  }
+  static Type Pow2(Type n) {
+    __m512i exponent = _mm512_add_epi32(_mm512_maskz_cvtps_epi32(0xFFFF, n),
+                                        _mm512_set1_epi32(127));
+    return _mm512_castsi512_ps(_mm512_maskz_slli_epi32(0xFFFF, exponent, 23));
+  }
+  static Type FMAdd(Type a, Type b, Type c) { return _mm512_fmadd_ps(a, b, c); }
+  static float Sum(Type value) {
+    alignas(64) float lanes[kWidth];
+    _mm512_store_ps(lanes, value);
+    float sum = 0.0f;
+    for (size_t i = 0; i < kWidth; ++i) sum += lanes[i];
+    return sum;
+  }
+};
+#elif defined(__AVX2__) && defined(__FMA__)
+template <>
+struct Vec<double> {
+  using Type = __m256d;
+  static constexpr size_t kWidth = 4;
+  static Type Load(const double* ptr) { return _mm256_loadu_pd(ptr); }
+  static void Store(double* ptr, Type value) { _mm256_storeu_pd(ptr, value); }
+  static Type Set1(double value) { return _mm256_set1_pd(value); }
+  static Type Zero() { return _mm256_setzero_pd(); }
+  static Type Add(Type a, Type b) { return _mm256_add_pd(a, b); }
+  static Type Mul(Type a, Type b) { return _mm256_mul_pd(a, b); }
+  static Type Sub(Type a, Type b) { return _mm256_sub_pd(a, b); }
+  static Type Div(Type a, Type b) { return _mm256_div_pd(a, b); }
+  static Type Min(Type a, Type b) { return _mm256_min_pd(a, b); }
+  static Type Max(Type a, Type b) { return _mm256_max_pd(a, b); }
+  static Type Round(Type a) {
+    return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Type Pow2(Type n) {
+    __m256i exponent = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    exponent = _mm256_add_epi64(exponent, _mm256_set1_epi64x(1023));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(exponent, 52));
+  }
+  static Type FMAdd(Type a, Type b, Type c) { return _mm256_fmadd_pd(a, b, c); }
+  static double Sum(Type value) {
+    __m128d low = _mm256_castpd256_pd128(value);
+    __m128d high = _mm256_extractf128_pd(value, 1);
+    low = _mm_add_pd(low, high);
+    return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+  }
+};
+
+template <>
+struct Vec<float> {
+  using Type = __m256;
+  static constexpr size_t kWidth = 8;
+  static Type Load(const float* ptr) { return _mm256_loadu_ps(ptr); }
+  static void Store(float* ptr, Type value) { _mm256_storeu_ps(ptr, value); }
+  static Type Set1(float value) { return _mm256_set1_ps(value); }
+  static Type Zero() { return _mm256_setzero_ps(); }
+  static Type Add(Type a, Type b) { return _mm256_add_ps(a, b); }
+  static Type Mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+  static Type Sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+  static Type Div(Type a, Type b) { return _mm256_div_ps(a, b); }
+  static Type Min(Type a, Type b) { return _mm256_min_ps(a, b); }
+  static Type Max(Type a, Type b) { return _mm256_max_ps(a, b); }
+  static Type Round(Type a) {
+    return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  }
+  static Type Pow2(Type n) {
+    __m256i exponent = _mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                        _mm256_set1_epi32(127));
+    return _mm256_castsi256_ps(_mm256_slli_epi32(exponent, 23));
+  }
+  static Type FMAdd(Type a, Type b, Type c) { return _mm256_fmadd_ps(a, b, c); }
+  static float Sum(Type value) {
+    __m128 low = _mm_add_ps(_mm256_castps256_ps128(value),
+                            _mm256_extractf128_ps(value, 1));
+    low = _mm_add_ps(low, _mm_movehl_ps(low, low));
+    return _mm_cvtss_f32(_mm_add_ss(low, _mm_movehdup_ps(low)));
+  }
+};
+#endif
+
+// Cache blocking parameters of Gemm, in elements.
+constexpr size_t kBlockK = 256;
+constexpr size_t kBlockM = 64;
+constexpr size_t kBlockN = 2048;
+constexpr size_t kMicroRows = 4;
+
+template <class T>
+T Dot(size_t n, const T* x, const T* y) {
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  auto acc0 = V::Zero();
+  auto acc1 = V::Zero();
+  size_t i = 0;
+  for (; i + 2 * w <= n; i += 2 * w) {
+    acc0 = V::FMAdd(V::Load(x + i), V::Load(y + i), acc0);
+    acc1 = V::FMAdd(V::Load(x + i + w), V::Load(y + i + w), acc1);
+  }
+  for (; i + w <= n; i += w)
+    acc0 = V::FMAdd(V::Load(x + i), V::Load(y + i), acc0);
+  T sum = V::Sum(V::Add(acc0, acc1));
+  for (; i < n; ++i) sum += x[i] * y[i];
+  return sum;
+}
+
+// y += alpha * x
+template <class T>
+void Axpy(size_t n, T alpha, const T* x, T* y) {
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  auto a = V::Set1(alpha);
+  size_t i = 0;
+  for (; i + w <= n; i += w)
+    V::Store(y + i, V::FMAdd(a, V::Load(x + i), V::Load(y + i)));
+  for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+template <class T>
+void Scale(size_t n, T alpha, T* x) {
+  if (alpha == T(1)) return;
+  if (alpha == T()) {
+    std::fill(x, x + n, T());
+    return;
+  }
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  auto a = V::Set1(alpha);
+  size_t i = 0;
+  for (; i + w <= n; i += w) V::Store(x + i, V::Mul(a, V::Load(x + i)));
+  for (; i < n; ++i) x[i] *= alpha;
+}
+
+// Range reduction constants of Exp: ln(2) split so that n * kLn2Hi is
+// exact, and the degree of the Taylor polynomial used on the remainder.
+template <class T>
+struct ExpTraits;
+
+template <>
+struct ExpTraits<double> {
+  static constexpr double kMax = 708.0;
+  static constexpr double kLn2Hi = 6.93145751953125e-1;
+  static constexpr double kLn2Lo = 1.42860682030941723212e-6;
+  static constexpr size_t kDegree = 11;
+};
+
+template <>
+struct ExpTraits<float> {
+  static constexpr float kMax = 87.0f;
+  static constexpr float kLn2Hi = 0.693359375f;
+  static constexpr float kLn2Lo = -2.12194440e-4f;
+  static constexpr size_t kDegree = 7;
+};
+
+// 1 / k! for k = 0..N, the Taylor coefficients of exp.
+template <class T, size_t N>
+struct InverseFactorials {
+  constexpr InverseFactorials() : values() {
+    T value = T(1);
+    for (size_t k = 0; k <= N; ++k) {
+      if (k > 1) value /= T(k);
+      values[k] = value;
+    }
+  }
+  T values[N + 1];
+};
+
+// exp(x) = 2^n * exp(r) with n = round(x / ln(2)) and |r| <= ln(2) / 2.
+// The relative error stays below 1e-14 for double and 1e-7 for float,
+// measured against long double exp over the clamped range; arguments are
+// clamped to the range where 2^n is a normal number.
+template <class V, class T>
+typename V::Type Exp(typename V::Type x) {
+  using Traits = ExpTraits<T>;
+  x = V::Min(V::Max(x, V::Set1(-Traits::kMax)), V::Set1(Traits::kMax));
+  auto n = V::Round(V::Mul(x, V::Set1(T(1.4426950408889634))));
+  auto r = V::FMAdd(n, V::Set1(-Traits::kLn2Hi), x);
+  r = V::FMAdd(n, V::Set1(-Traits::kLn2Lo), r);
+  static constexpr InverseFactorials<T, Traits::kDegree> kCoefficients;
+  auto p = V::Set1(kCoefficients.values[Traits::kDegree]);
+  for (size_t k = Traits::kDegree; k-- > 0;)
+    p = V::FMAdd(p, r, V::Set1(kCoefficients.values[k]));
+  return V::Mul(p, V::Pow2(n));
+}
+
+// Relative error below 1e-14 for double and 2e-7 for float.
+template <class V, class T>
+typename V::Type Sigmoid(typename V::Type x) {
+  auto one = V::Set1(T(1));
+  return V::Div(one, V::Add(one, Exp<V, T>(V::Sub(V::Zero(), x))));
+}
+
+// Elementwise functions for BiasMap, applied to a register of any Vec.
+struct ExpKernel {
+  template <class V, class T>
+  static typename V::Type Apply(typename V::Type x) {
+    return Exp<V, T>(x);
+  }
+};
+
+struct SigmoidKernel {
+  template <class V, class T>
+  static typename V::Type Apply(typename V::Type x) {
+    return Sigmoid<V, T>(x);
+  }
+};
+
+// tanh(x) = 2 * sigmoid(2x) - 1.
+struct TanhKernel {
+  template <class V, class T>
+  static typename V::Type Apply(typename V::Type x) {
+    auto two = V::Set1(T(2));
+    return V::Sub(V::Mul(two, Sigmoid<V, T>(V::Mul(two, x))), V::Set1(T(1)));
+  }
+};
+
+struct ReluKernel {
+  template <class V, class T>
+  static typename V::Type Apply(typename V::Type x) {
+    return V::Max(x, V::Zero());
+  }
+};
+
+struct LeakyReluKernel {
+  static constexpr double kSlope = 0.01;
+
+  template <class V, class T>
+  static typename V::Type Apply(typename V::Type x) {
+    return V::Max(x, V::Mul(x, V::Set1(T(kSlope))));
+  }
+};
+
+// x[i] = K(x[i] + bias[i * bias_stride]): a stride of 1 adds a bias per
+// element, a stride of 0 the same bias to all of them.
+template <class K, class T>
+void BiasMap(size_t n, const T* bias, size_t bias_stride, T* x) {
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  size_t i = 0;
+  if (bias_stride == 0) {
+    auto b = V::Set1(*bias);
+    for (; i + w <= n; i += w)
+      V::Store(x + i, K::template Apply<V, T>(V::Add(V::Load(x + i), b)));
+  } else {
+    for (; i + w <= n; i += w)
+      V::Store(x + i, K::template Apply<V, T>(
+                          V::Add(V::Load(x + i), V::Load(bias + i))));
+  }
+  for (bias += i * bias_stride; i < n; ++i, bias += bias_stride)
+    x[i] = K::template Apply<ScalarVec<T>, T>(x[i] + *bias);
+}
+
+// Softmax of every column of the rows x cols block x + bias, where bias
+// holds one value per row.
+template <class T>
+void BiasSoftmax(size_t rows, size_t cols, const T* bias, T* x) {
+  if (cols == 1) {
+    T shift = -std::numeric_limits<T>::infinity();
+    for (size_t row = 0; row < rows; ++row) {
+      x[row] += bias[row];
+      shift = std::max(shift, x[row]);
+    }
+    shift = -shift;
+    BiasMap<ExpKernel>(rows, &shift, 0, x);
+    T sum = T();
+    for (size_t row = 0; row < rows; ++row) sum += x[row];
+    for (size_t row = 0; row < rows; ++row) x[row] /= sum;
+    return;
+  }
+  // Column maxima, sums and their inverses are kept one per column so
+  // that every pass runs along the contiguous rows.
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  thread_local std::vector<T> shift;
+  thread_local std::vector<T> sum;
+  shift.assign(cols, -std::numeric_limits<T>::infinity());
+  sum.assign(cols, T());
+  T* shifts = shift.data();
+  T* sums = sum.data();
+  for (size_t row = 0; row < rows; ++row) {
+    T* values = x + row * cols;
+    auto b = V::Set1(bias[row]);
+    size_t col = 0;
+    for (; col + w <= cols; col += w) {
+      auto value = V::Add(V::Load(values + col), b);
+      V::Store(values + col, value);
+      V::Store(shifts + col, V::Max(V::Load(shifts + col), value));
+    }
+    for (; col < cols; ++col) {
+      values[col] += bias[row];
+      shifts[col] = std::max(shifts[col], values[col]);
+    }
+  }
+  for (size_t col = 0; col < cols; ++col) shifts[col] = -shifts[col];
+  for (size_t row = 0; row < rows; ++row) {
+    T* values = x + row * cols;
+    BiasMap<ExpKernel>(cols, shifts, 1, values);
+    size_t col = 0;
+    for (; col + w <= cols; col += w)
+      V::Store(sums + col, V::Add(V::Load(sums + col), V::Load(values + col)));
+    for (; col < cols; ++col) sums[col] += values[col];
+  }
+  for (size_t col = 0; col < cols; ++col) sums[col] = T(1) / sums[col];
+  for (size_t row = 0; row < rows; ++row) {
+    T* values = x + row * cols;
+    size_t col = 0;
+    for (; col + w <= cols; col += w)
+      V::Store(values + col,
+               V::Mul(V::Load(values + col), V::Load(sums + col)));
+    for (; col < cols; ++col) values[col] *= sums[col];
+  }
+}
+
+// Elementwise x[i] = function(x[i]); the functor is a template parameter
+// so the call is inlined into the loop.
+template <class T, class F>
+void Map(size_t n, T* x, F function) {
+  for (size_t i = 0; i < n; ++i) x[i] = function(x[i]);
+}
+
+// Register-blocked MR x n tile of C += A * B, where A is a packed MR x kc
+// block and B a packed kc x n panel.
+template <class T, size_t MR>
+void MicroKernel(size_t kc, size_t n, const T* a, const T* b, size_t ldb, T* c,
+                 size_t ldc) {
+  using V = Vec<T>;
+  constexpr size_t w = V::kWidth;
+  size_t j = 0;
+  for (; j + 2 * w <= n; j += 2 * w) {
+    typename V::Type acc[MR][2];
+    for (size_t r = 0; r < MR; ++r) {
+      acc[r][0] = V::Load(c + r * ldc + j);
+      acc[r][1] = V::Load(c + r * ldc + j + w);
+    }
+    for (size_t p = 0; p < kc; ++p) {
+      auto b0 = V::Load(b + p * ldb + j);
+      auto b1 = V::Load(b + p * ldb + j + w);
+      for (size_t r = 0; r < MR; ++r) {
+        auto a_rp = V::Set1(a[r * kc + p]);
+        acc[r][0] = V::FMAdd(a_rp, b0, acc[r][0]);
+        acc[r][1] = V::FMAdd(a_rp, b1, acc[r][1]);
+      }
+    }
+    for (size_t r = 0; r < MR; ++r) {
+      V::Store(c + r * ldc + j, acc[r][0]);
+      V::Store(c + r * ldc + j + w, acc[r][1]);
+    }
+  }
+  for (; j + w <= n; j += w) {
+    typename V::Type acc[MR];
+    for (size_t r = 0; r < MR; ++r) acc[r] = V::Load(c + r * ldc + j);
+    for (size_t p = 0; p < kc; ++p) {
+      auto b0 = V::Load(b + p * ldb + j);
+      for (size_t r = 0; r < MR; ++r)
+        acc[r] = V::FMAdd(V::Set1(a[r * kc + p]), b0, acc[r]);
+    }
+    for (size_t r = 0; r < MR; ++r) V::Store(c + r * ldc + j, acc[r]);
+  }
+  for (; j < n; ++j)
+    for (size_t r = 0; r < MR; ++r) {
+      T sum = c[r * ldc + j];
+      for (size_t p = 0; p < kc; ++p) sum += a[r * kc + p] * b[p * ldb + j];
+      c[r * ldc + j] = sum;
+    }
+}
+
+// y = alpha * op(A) * x + beta * y, A is m x n row-major.
+template <class T>
+void Gemv(bool trans, size_t m, size_t n, T alpha, const T* a, size_t lda,
+          const T* x, T beta, T* y) {
+  if (!trans) {
+    for (size_t i = 0; i < m; ++i) {
+      T sum = alpha * Dot(n, a + i * lda, x);
+      y[i] = beta == T() ? sum : sum + beta * y[i];
+    }
+  } else {
+    Scale(n, beta, y);
+    for (size_t i = 0; i < m; ++i) Axpy(n, alpha * x[i], a + i * lda, y);
+  }
+}
+
+// A += alpha * x * y^T, A is m x n row-major.
+template <class T>
+void Ger(size_t m, size_t n, T alpha, const T* x, const T* y, T* a,
+         size_t lda) {
+  for (size_t i = 0; i < m; ++i) Axpy(n, alpha * x[i], y, a + i * lda);
+}
+
+// C = alpha * op(A) * op(B) + beta * C, all matrices row-major. op(A) is
+// m x k, op(B) is k x n. Both operands are packed block by block into
+// thread-local buffers, so transposed operands cost one pass over memory and
+// repeated calls do not allocate.
+template <class T>
+void Gemm(bool trans_a, bool trans_b, size_t m, size_t n, size_t k, T alpha,
+          const T* a, size_t lda, const T* b, size_t ldb, T beta, T* c,
+          size_t ldc) {
+  if (n == 1 && ldc == 1 && (trans_b || ldb == 1)) {
+    Gemv(trans_a, trans_a ? k : m, trans_a ? m : k, alpha, a, lda, b, beta, c);
+    return;
+  }
+  if (m == 1 && !trans_a && !trans_b) {
+    Scale(n, beta, c);
+    for (size_t p = 0; p < k; ++p) Axpy(n, alpha * a[p], b + p * ldb, c);
+    return;
+  }
+  for (size_t i = 0; i < m; ++i) Scale(n, beta, c + i * ldc);
+  if (k == 0 || alpha == T()) return;
+
+  thread_local std::vector<T> packed_a;
+  thread_local std::vector<T> packed_b;
+  packed_a.resize(kBlockM * kBlockK);
+  packed_b.resize(kBlockK * std::min(n, kBlockN));
+
+  for (size_t jc = 0; jc < n; jc += kBlockN) {
+    size_t nc = std::min(kBlockN, n - jc);
+    for (size_t pc = 0; pc < k; pc += kBlockK) {
+      size_t kc = std::min(kBlockK, k - pc);
+      for (size_t p = 0; p < kc; ++p)
+        for (size_t j = 0; j < nc; ++j)
+          packed_b[p * nc + j] = trans_b ? b[(jc + j) * ldb + pc + p]
+                                         : b[(pc + p) * ldb + jc + j];
+      for (size_t ic = 0; ic < m; ic += kBlockM) {
+        size_t mc = std::min(kBlockM, m - ic);
+        for (size_t i = 0; i < mc; ++i)
+          for (size_t p = 0; p < kc; ++p)
+            packed_a[i * kc + p] =
+                alpha * (trans_a ? a[(pc + p) * lda + ic + i]
+                                 : a[(ic + i) * lda + pc + p]);
+        size_t i = 0;
+        for (; i + kMicroRows <= mc; i += kMicroRows)
+          MicroKernel<T, kMicroRows>(kc, nc, packed_a.data() + i * kc,
+                                     packed_b.data(), nc,
+                                     c + (ic + i) * ldc + jc, ldc);
+        for (; i < mc; ++i)
+          MicroKernel<T, 1>(kc, nc, packed_a.data() + i * kc, packed_b.data(),
+                            nc, c + (ic + i) * ldc + jc, ldc);
+      }
+    }
+  }
+}
+
+}  // namespace kernels
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_KERNELS_H_
@@ -1,342 +1,550 @@
 #include "layers.h"
 
 namespace s21 {
-Layers::Layers(size_t hidden_layers_count)
-    : hidden_layers_count_(hidden_layers_count) {
-  deltas_for_weights_.reserve(hidden_layers_count + 1);
-  deltas_for_biases_.reserve(hidden_layers_count + 1);
-
-  deltas_for_weights_.push_back(
-      S21Matrix<double>(kNeuronsOnHiddenLayerCount, kInputNeuronsCount));
-  for (size_t layer = 0; layer < hidden_layers_count; ++layer) {
-    if (layer != hidden_layers_count - 1)
-      deltas_for_weights_.push_back(
-          S21Matrix<double>(kNeuronsOnHiddenLayerCount));
-    deltas_for_biases_.push_back(
-        S21Matrix<double>(kNeuronsOnHiddenLayerCount, 1));
+namespace {
+// y += alpha * x, widening x to the type of y.
+template <class T, class W>
+void Accumulate(size_t n, W alpha, const T* x, W* y) {
+  if constexpr (std::is_same_v<T, W>) {
+    kernels::Axpy(n, alpha, x, y);
+  } else {
+    for (size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+  }
+}
+}  // namespace
+
+template <class T>
+void Workspace<T>::Reserve(const std::vector<size_t>& layer_sizes,
+                           size_t batch_capacity) {
+  if (layer_sizes == layer_sizes_ && batch_capacity <= batch_capacity_)
+    return;
+  layer_sizes_ = layer_sizes;
+  batch_capacity_ = std::max(batch_capacity, batch_capacity_);
+  activation_offsets_.assign(1, 0);
+  for (size_t layer = 0; layer < layer_sizes.size(); ++layer)
+    activation_offsets_.push_back(activation_offsets_.back() +
+                                  layer_sizes[layer] * batch_capacity_);
+  delta_offsets_.assign(1, activation_offsets_.back());
+  for (size_t layer = 1; layer < layer_sizes.size(); ++layer)
+    delta_offsets_.push_back(delta_offsets_.back() +
+                             layer_sizes[layer] * batch_capacity_);
+  buffer_.assign(delta_offsets_.back(), T());
+}
+
+template <class T>
+size_t Workspace<T>::GetBatchCapacity() const noexcept {
+  return batch_capacity_;
+}
+
+template <class T>
+T* Workspace<T>::GetActivations(size_t layer) noexcept {
+  return buffer_.data() + activation_offsets_[layer];
+}
+
+template <class T>
+const T* Workspace<T>::GetActivations(size_t layer) const noexcept {
+  return buffer_.data() + activation_offsets_[layer];
+}
+
+// Deltas exist for every layer but the input one; layer is counted from
+// the first hidden layer.
+template <class T>
+T* Workspace<T>::GetDeltas(size_t layer) noexcept {
+  return buffer_.data() + delta_offsets_[layer];
+}
+
+template <class T>
+S21Matrix<T>& Workspace<T>::GetImages(size_t rows, size_t capacity) {
+  if (images_.GetRows() != rows || images_.GetCols() < capacity)
+    images_ = S21Matrix<T>(rows, capacity);
+  return images_;
+}
+
+template <class T>
+S21Matrix<T>& Workspace<T>::GetImage(size_t rows) {
+  if (image_.GetRows() != rows || image_.GetCols() != 1)
+    image_ = S21Matrix<T>(rows, 1);
+  return image_;
+}
+
+template <class T>
+std::vector<size_t>& Workspace<T>::GetExpectedClasses() noexcept {
+  return expected_classes_;
+}
+
+template <class T, class A>
+Layers<T, A>::Layers(const std::vector<size_t>& layer_sizes)
+    : layer_sizes_(layer_sizes) {
+  CheckLayerSizes(layer_sizes);
+  AllocateDeltas();
+}
+
+template <class T, class A>
+Layers<T, A>::~Layers() {}
+
+template <class T, class A>
+template <class W>
+void Layers<T, A>::UpdateWeights(std::vector<S21Matrix<W>>& weights,
+                                 std::vector<S21Matrix<W>>& biases,
+                                 double learning_rate) {
+  W scale = -learning_rate / mini_batch_size_;
+  for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
+    Accumulate(biases[layer].GetRows(), scale,
+               deltas_for_biases_[layer].Data(), biases[layer].Data());
+    Accumulate(weights[layer].GetRows() * weights[layer].GetCols(), scale,
+               deltas_for_weights_[layer].Data(), weights[layer].Data());
+  }
+}
+
+template <class T, class A>
+void Layers<T, A>::ChangeLayerSizes(const std::vector<size_t>& layer_sizes) {
+  CheckLayerSizes(layer_sizes);
+  layer_sizes_ = layer_sizes;
+  AllocateDeltas();
+}
+
+template <class T, class A>
+void Layers<T, A>::TrainMiniBatch(const S21Matrix<T>& images,
+                                  const std::vector<size_t>& expected_classes,
+                                  std::vector<S21Matrix<T>>& weights,
+                                  const std::vector<S21Matrix<T>>& biases,
+                                  std::vector<double>& losses) {
+  for (size_t col = 0; col < expected_classes.size(); ++col) {
+    CopyColumn(images, col);
+    FeedForward(column_, weights, biases);
+    BackPropogation(expected_classes[col], weights);
+    losses.push_back(TotalCost(expected_classes[col]));
   }
-  deltas_for_weights_.push_back(
-      S21Matrix<double>(kOutputNeuronsCount, kNeuronsOnHiddenLayerCount));
-  deltas_for_biases_.push_back(S21Matrix<double>(kOutputNeuronsCount, 1));
 }
 
-Layers::~Layers() {}
+template <class T, class A>
+void Layers<T, A>::PredictBatch(const S21Matrix<T>& images,
+                                const std::vector<S21Matrix<T>>& weights,
+                                const std::vector<S21Matrix<T>>& biases,
+                                std::vector<size_t>& predictions) {
+  for (size_t col = 0; col < images.GetCols(); ++col) {
+    CopyColumn(images, col);
+    FeedForward(column_, weights, biases);
+    predictions.push_back(GetMaxOutputIndex());
+  }
+}
 
-void Layers::UpdateWeights(std::vector<S21Matrix<double>>& weights,
-                           std::vector<S21Matrix<double>>& biases,
-                           double learning_rate) {
+template <class T, class A>
+void Layers<T, A>::ResetDeltas() {
   for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
-    biases[layer] -=
-        learning_rate / mini_batch_size_ * deltas_for_biases_[layer];
-    weights[layer] -=
-        learning_rate / mini_batch_size_ * deltas_for_weights_[layer];
+    kernels::Scale(deltas_for_biases_[layer].GetRows(), A(0),
+                   deltas_for_biases_[layer].Data());
+    kernels::Scale(deltas_for_weights_[layer].GetRows() *
+                       deltas_for_weights_[layer].GetCols(),
+                   A(0), deltas_for_weights_[layer].Data());
   }
 }
 
-void Layers::ResetDeltas() {
+template <class T, class A>
+void Layers<T, A>::AddDeltas(const Layers& other) {
+  if (layer_sizes_ != other.layer_sizes_)
+    throw std::runtime_error("Layers have different sizes");
   for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
-    deltas_for_biases_[layer] *= 0;
-    deltas_for_weights_[layer] *= 0;
+    kernels::Axpy(deltas_for_biases_[layer].GetRows(), A(1),
+                  other.deltas_for_biases_[layer].Data(),
+                  deltas_for_biases_[layer].Data());
+    kernels::Axpy(deltas_for_weights_[layer].GetRows() *
+                      deltas_for_weights_[layer].GetCols(),
+                  A(1), other.deltas_for_weights_[layer].Data(),
+                  deltas_for_weights_[layer].Data());
   }
 }
 
-void Layers::SetMiniBatchSize(size_t size) {
+template <class T, class A>
+void Layers<T, A>::SetMiniBatchSize(size_t size) {
   if (size == 0) throw std::runtime_error("Invalid size");
   mini_batch_size_ = size;
 }
 
-size_t Layers::GetMiniBatchSize() const noexcept { return mini_batch_size_; }
+template <class T, class A>
+size_t Layers<T, A>::GetMiniBatchSize() const noexcept {
+  return mini_batch_size_;
+}
 
-MatrixLayers::MatrixLayers(size_t hidden_layers_count)
-    : Layers(hidden_layers_count) {
-  neurons_.reserve(hidden_layers_count + 2);
-  neurons_.push_back(S21Matrix<double>(kInputNeuronsCount, 1));
-  for (size_t layer = 0; layer < hidden_layers_count; ++layer) {
-    neurons_.push_back(S21Matrix<double>(kNeuronsOnHiddenLayerCount, 1));
-  }
-  neurons_.push_back(S21Matrix<double>(kOutputNeuronsCount, 1));
+template <class T, class A>
+Workspace<T>& Layers<T, A>::GetWorkspace() noexcept { return workspace_; }
+
+template <class T, class A>
+void Layers<T, A>::SetFunctions(const NetworkFunctions& functions) noexcept {
+  functions_ = functions;
 }
 
-MatrixLayers::~MatrixLayers() {}
+template <class T, class A>
+const NetworkFunctions& Layers<T, A>::GetFunctions() const noexcept {
+  return functions_;
+}
 
-void MatrixLayers::FeedForward(const S21Matrix<double>& image,
-                               const std::vector<S21Matrix<double>>& weights,
-                               const std::vector<S21Matrix<double>>& biases) {
-  neurons_.front() = image;
-  for (size_t layer = 1; layer < hidden_layers_count_ + 2; ++layer) {
-    neurons_[layer] =
-        weights[layer - 1] * neurons_[layer - 1] + biases[layer - 1];
-    neurons_[layer].UseFunction(Sigmoid::SigmoidFunction);
+template <class T, class A>
+const std::vector<size_t>& Layers<T, A>::GetLayerSizes() const noexcept {
+  return layer_sizes_;
+}
+
+template <class T, class A>
+size_t Layers<T, A>::GetInputsCount() const noexcept {
+  return layer_sizes_.front();
+}
+
+template <class T, class A>
+size_t Layers<T, A>::GetOutputsCount() const noexcept {
+  return layer_sizes_.back();
+}
+
+template <class T, class A>
+void Layers<T, A>::CheckLayerSizes(const std::vector<size_t>& layer_sizes) {
+  if (layer_sizes.size() < 2)
+    throw std::runtime_error("Network needs an input and an output layer");
+  for (size_t size : layer_sizes)
+    if (size == 0) throw std::runtime_error("Layers can not be empty");
+}
+
+template <class T, class A>
+void Layers<T, A>::AllocateDeltas() {
+  hidden_layers_count_ = layer_sizes_.size() - 2;
+  deltas_for_weights_.clear();
+  deltas_for_biases_.clear();
+  staged_deltas_.clear();
+  for (size_t layer = 0; layer + 1 < layer_sizes_.size(); ++layer) {
+    deltas_for_weights_.push_back(
+        S21Matrix<A>(layer_sizes_[layer + 1], layer_sizes_[layer]));
+    deltas_for_biases_.push_back(S21Matrix<A>(layer_sizes_[layer + 1], 1));
+    if constexpr (!std::is_same_v<T, A>)
+      staged_deltas_.push_back(
+          S21Matrix<T>(layer_sizes_[layer + 1], layer_sizes_[layer]));
   }
+  column_ = S21Matrix<T>(GetInputsCount(), 1);
+}
+
+template <class T, class A>
+void Layers<T, A>::CopyColumn(const S21Matrix<T>& images, size_t col) {
+  if (images.GetRows() != GetInputsCount() || col >= images.GetCols())
+    throw std::runtime_error("Images do not match the input layer");
+  T* column = column_.Data();
+  for (size_t row = 0; row < GetInputsCount(); ++row)
+    column[row] = images.UncheckedAt(row, col);
+}
+
+template <class T, class A>
+MatrixLayers<T, A>::MatrixLayers(const std::vector<size_t>& layer_sizes)
+    : Layers<T, A>(layer_sizes) {
+  workspace_.Reserve(layer_sizes_, mini_batch_size_);
+}
+
+template <class T, class A>
+MatrixLayers<T, A>::~MatrixLayers() {}
+
+template <class T, class A>
+void MatrixLayers<T, A>::FeedForward(const S21Matrix<T>& image,
+                                     const std::vector<S21Matrix<T>>& weights,
+                                     const std::vector<S21Matrix<T>>& biases) {
+  if (image.GetRows() != GetInputsCount() || image.GetCols() != 1)
+    throw std::runtime_error("Image does not match the input layer");
+  const T* pixels = image.Data();
+  std::copy(pixels, pixels + GetInputsCount(),
+            workspace_.GetActivations(0));
+  FeedForwardBatch(workspace_.GetActivations(0), 1, 1, weights, biases);
 }
 
-size_t MatrixLayers::GetMaxOutputIndex() const noexcept {
-  double max = neurons_.back()(0, 0);
+template <class T, class A>
+size_t MatrixLayers<T, A>::GetMaxOutputIndex() const noexcept {
+  const T* outputs = workspace_.GetActivations(hidden_layers_count_ + 1);
   size_t max_index = 0;
-  for (size_t row = 1; row < kOutputNeuronsCount; ++row) {
-    double value = neurons_.back()(row, 0);
-    if (value > max) {
-      max = value;
+  for (size_t row = 1; row < GetOutputsCount(); ++row)
+    if (outputs[row * batch_count_] > outputs[max_index * batch_count_])
       max_index = row;
-    }
-  }
   return max_index;
 }
 
-void MatrixLayers::ChangeNumberOfHiddenLayers(size_t number) {
-  if (number < 2 || number > 5)
-    throw std::runtime_error(
-        "Number of hidden layers should be between 2 and 5");
-  if (number == hidden_layers_count_) return;
-  if (number > hidden_layers_count_) {
-    neurons_.insert(neurons_.end() - 1, number - hidden_layers_count_,
-                    S21Matrix<double>(kNeuronsOnHiddenLayerCount, 1));
-    deltas_for_weights_.insert(deltas_for_weights_.end() - 1,
-                               number - hidden_layers_count_,
-                               S21Matrix<double>(kNeuronsOnHiddenLayerCount));
-
-    deltas_for_biases_.insert(deltas_for_biases_.end() - 1,
-                              number - hidden_layers_count_,
-                              S21Matrix<double>(kNeuronsOnHiddenLayerCount, 1));
-  } else {
-    neurons_.erase(neurons_.begin() + 1,
-                   neurons_.begin() + 1 + hidden_layers_count_ - number);
-    deltas_for_weights_.erase(
-        deltas_for_weights_.begin() + 1,
-        deltas_for_weights_.begin() + 1 + hidden_layers_count_ - number);
-    deltas_for_biases_.erase(
-        deltas_for_biases_.begin(),
-        deltas_for_biases_.begin() + hidden_layers_count_ - number);
-  }
-  hidden_layers_count_ = number;
+template <class T, class A>
+void MatrixLayers<T, A>::BackPropogation(size_t expected_class,
+                                         std::vector<S21Matrix<T>>& weights) {
+  if (batch_count_ != 1)
+    throw std::runtime_error("BackPropogation follows a batched pass");
+  BackPropogationBatch(workspace_.GetActivations(0), 1, &expected_class, 1,
+                       weights);
 }
 
-void MatrixLayers::BackPropogation(unsigned char expected_result,
-                                   std::vector<S21Matrix<double>>& weights) {
-  auto deltas = deltas_for_biases_;
+template <class T, class A>
+double MatrixLayers<T, A>::TotalCost(size_t expected_class) const {
+  const T* outputs = workspace_.GetActivations(hidden_layers_count_ + 1);
+  return functions_.GetLoss(GetOutputsCount(), batch_count_, outputs, 0,
+                            expected_class);
+}
 
-  for (size_t row = 0; row < kOutputNeuronsCount; ++row) {
-    auto neuron_value = neurons_.back()(row, 0);
-    double exp_res = 0.0;
-    if (row == static_cast<size_t>(expected_result - 97)) exp_res = 1.0;
-    deltas.back()(row, 0) =
-        Sigmoid::SigmoidDerivative(neuron_value) * (neuron_value - exp_res);
-  }
+template <class T, class A>
+void MatrixLayers<T, A>::TrainMiniBatch(
+    const S21Matrix<T>& images,
+    const std::vector<size_t>& expected_classes,
+    std::vector<S21Matrix<T>>& weights,
+    const std::vector<S21Matrix<T>>& biases,
+    std::vector<double>& losses) {
+  size_t count = expected_classes.size();
+  if (images.GetRows() != GetInputsCount() || images.GetCols() < count)
+    throw std::runtime_error("Mini-batch does not match the input layer");
+  FeedForwardBatch(images.Data(), images.GetCols(), count, weights, biases);
+  BackPropogationBatch(images.Data(), images.GetCols(),
+                       expected_classes.data(), count, weights);
+
+  const T* outputs = workspace_.GetActivations(hidden_layers_count_ + 1);
+  for (size_t col = 0; col < count; ++col)
+    losses.push_back(functions_.GetLoss(GetOutputsCount(), count, outputs,
+                                        col, expected_classes[col]));
+}
 
-  for (size_t layer = hidden_layers_count_; layer > 0; --layer) {
-    deltas[layer - 1] = weights[layer].Transpose() * deltas[layer];
-    for (size_t row = 0; row < deltas[layer - 1].GetRows(); ++row) {
-      auto neuron_value = neurons_[layer](row, 0);
-      deltas[layer - 1](row, 0) *= Sigmoid::SigmoidDerivative(neuron_value);
-    }
+template <class T, class A>
+void MatrixLayers<T, A>::PredictBatch(const S21Matrix<T>& images,
+                                      const std::vector<S21Matrix<T>>& weights,
+                                      const std::vector<S21Matrix<T>>& biases,
+                                      std::vector<size_t>& predictions) {
+  size_t count = images.GetCols();
+  if (images.GetRows() != GetInputsCount())
+    throw std::runtime_error("Images do not match the input layer");
+  FeedForwardBatch(images.Data(), count, count, weights, biases);
+  const T* outputs = workspace_.GetActivations(hidden_layers_count_ + 1);
+  for (size_t col = 0; col < count; ++col) {
+    size_t max_index = 0;
+    for (size_t row = 1; row < GetOutputsCount(); ++row)
+      if (outputs[row * count + col] > outputs[max_index * count + col])
+        max_index = row;
+    predictions.push_back(max_index);
   }
+}
 
+// Activations of layer l are layer_sizes_[l] x count, one column per
+// sample. Every layer is one GEMM into the workspace followed by a fused
+// bias add and activation.
+template <class T, class A>
+void MatrixLayers<T, A>::FeedForwardBatch(
+    const T* input, size_t input_stride, size_t count,
+    const std::vector<S21Matrix<T>>& weights,
+    const std::vector<S21Matrix<T>>& biases) {
+  if (weights.size() != hidden_layers_count_ + 1 ||
+      biases.size() != weights.size())
+    throw std::runtime_error("Weights do not match the network");
+  workspace_.Reserve(layer_sizes_, count);
+  batch_count_ = count;
+  size_t stride = input_stride;
   for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
-    deltas_for_biases_[layer] += deltas[layer];
-    deltas_for_weights_[layer] += deltas[layer] * neurons_[layer].Transpose();
+    size_t rows = layer_sizes_[layer + 1];
+    size_t cols = layer_sizes_[layer];
+    if (weights[layer].GetRows() != rows || weights[layer].GetCols() != cols)
+      throw std::runtime_error("Weights do not match the network");
+    T* output = workspace_.GetActivations(layer + 1);
+    kernels::Gemm(false, false, rows, count, cols, T(1),
+                  weights[layer].Data(), cols, input, stride, T(0),
+                  output, count);
+    if (layer != hidden_layers_count_)
+      functions_.ActivateHidden(rows, count, biases[layer].Data(), output);
+    else
+      functions_.ActivateOutput(rows, count, biases[layer].Data(), output);
+    input = output;
+    stride = count;
   }
 }
 
-double MatrixLayers::TotalCost(unsigned char expected_result) const {
-  double sum = 0;
-  for (size_t row = 0; row < kOutputNeuronsCount; ++row) {
-    double value = neurons_.back()(row, 0);
-    if (row == static_cast<size_t>(expected_result - 97)) {
-      sum += (1.0 - value) * (1.0 - value);
-    } else {
-      sum += (0.0 - value) * (0.0 - value);
-    }
-  }
-  return sum / 2.0;
-}
-
-GraphLayers::GraphLayers(size_t hidden_layers_count)
-    : Layers(hidden_layers_count) {
-  root_0_0_neuron_ = new Neuron();
-  root_0_0_neuron_->outputs.reserve(kNeuronsOnHiddenLayerCount);
-  for (size_t i = 0; i < kNeuronsOnHiddenLayerCount; ++i)
-    root_0_0_neuron_->outputs.push_back(new Neuron());
-  root_0_0_neuron_->outputs.front()->inputs.reserve(kInputNeuronsCount);
-  root_0_0_neuron_->outputs.front()->inputs.push_back(root_0_0_neuron_);
-  for (size_t i = 1; i < kInputNeuronsCount; ++i) {
-    root_0_0_neuron_->outputs.front()->inputs.push_back(new Neuron());
-    root_0_0_neuron_->outputs.front()->inputs[i]->outputs =
-        root_0_0_neuron_->outputs;
-  }
-  auto this_layer = root_0_0_neuron_;
-  auto next_layer = root_0_0_neuron_->outputs.front();
-  for (size_t i = 0; i < hidden_layers_count_; ++i) {
-    if (i != hidden_layers_count_ - 1)
-      next_layer->outputs.reserve(kNeuronsOnHiddenLayerCount);
-    else
-      next_layer->outputs.reserve(kOutputNeuronsCount);
-    for (size_t j = 0; j < next_layer->outputs.capacity(); ++j)
-      next_layer->outputs.push_back(new Neuron());
-    for (size_t j = 1; j < kNeuronsOnHiddenLayerCount; ++j) {
-      this_layer->outputs[j]->inputs = next_layer->inputs;
-      this_layer->outputs[j]->outputs = next_layer->outputs;
-    }
-    this_layer = next_layer;
-    next_layer = this_layer->outputs.front();
-    next_layer->inputs = this_layer->inputs.front()->outputs;
-  }
-  for (size_t i = 1; i < kOutputNeuronsCount; ++i) {
-    this_layer->outputs[i]->inputs = next_layer->inputs;
+template <class T, class A>
+void MatrixLayers<T, A>::BackPropogationBatch(
+    const T* input, size_t input_stride, const size_t* expected_classes,
+    size_t count, const std::vector<S21Matrix<T>>& weights) {
+  size_t output_layer = hidden_layers_count_ + 1;
+  const T* outputs = workspace_.GetActivations(output_layer);
+  functions_.ComputeOutputDeltas(GetOutputsCount(), count, outputs,
+                                 expected_classes,
+                                 workspace_.GetDeltas(output_layer - 1));
+
+  for (size_t layer = hidden_layers_count_; layer > 0; --layer) {
+    size_t rows = layer_sizes_[layer];
+    T* deltas = workspace_.GetDeltas(layer - 1);
+    kernels::Gemm(true, false, rows, count, layer_sizes_[layer + 1], T(1),
+                  weights[layer].Data(), rows,
+                  workspace_.GetDeltas(layer), count, T(0), deltas, count);
+    functions_.ApplyHiddenDerivative(
+        rows * count, workspace_.GetActivations(layer), deltas);
   }
-  pre_last_layer_neuron_ = this_layer;
-}
 
-GraphLayers::~GraphLayers() {
-  for (size_t i = 0; i < hidden_layers_count_; ++i) {
-    for (size_t j = 0; j < pre_last_layer_neuron_->outputs.size(); ++j) {
-      delete pre_last_layer_neuron_->outputs[j];
+  for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
+    size_t rows = layer_sizes_[layer + 1];
+    size_t cols = layer_sizes_[layer];
+    const T* deltas = workspace_.GetDeltas(layer);
+    const T* neurons =
+        layer == 0 ? input : workspace_.GetActivations(layer);
+    size_t stride = layer == 0 ? input_stride : count;
+    A* bias_deltas = deltas_for_biases_[layer].Data();
+    for (size_t row = 0; row < rows; ++row) {
+      T sum = T();
+      for (size_t col = 0; col < count; ++col) sum += deltas[row * count + col];
+      bias_deltas[row] += sum;
     }
-    if (i != hidden_layers_count_ - 1)
-      pre_last_layer_neuron_ = pre_last_layer_neuron_->inputs.front();
-  }
-  auto last_inputs = pre_last_layer_neuron_->inputs;
-  pre_last_layer_neuron_ = pre_last_layer_neuron_->inputs.front();
-
-  for (size_t j = 0; j < pre_last_layer_neuron_->outputs.size(); ++j)
-    delete pre_last_layer_neuron_->outputs[j];
-  for (size_t j = 0; j < last_inputs.size(); ++j) delete last_inputs[j];
-}
-
-void GraphLayers::FeedForward(const S21Matrix<double>& image,
-                              const std::vector<S21Matrix<double>>& weights,
-                              const std::vector<S21Matrix<double>>& biases) {
-  auto inputs = root_0_0_neuron_->outputs.front()->inputs;
-  for (size_t i = 0; i < kInputNeuronsCount; ++i) inputs[i]->val = image(i, 0);
-
-  auto layer = root_0_0_neuron_;
-  for (size_t i = 0; i < hidden_layers_count_ + 1; ++i) {
-    for (size_t neuron_idex = 0; neuron_idex < layer->outputs.size();
-         ++neuron_idex) {
-      double sum = 0;
-      for (size_t w_idex = 0; w_idex < layer->outputs.front()->inputs.size();
-           ++w_idex) {
-        sum += weights[i](neuron_idex, w_idex) *
-               layer->outputs.front()->inputs[w_idex]->val;
-      }
-      sum += biases[i](neuron_idex, 0);
-      sum = Sigmoid::SigmoidFunction(sum);
-      layer->outputs[neuron_idex]->val = sum;
+    A* weight_deltas = deltas_for_weights_[layer].Data();
+    if constexpr (std::is_same_v<T, A>) {
+      if (count == 1 && stride == 1)
+        kernels::Ger(rows, cols, T(1), deltas, neurons, weight_deltas, cols);
+      else
+        kernels::Gemm(false, true, rows, cols, count, T(1), deltas, count,
+                      neurons, stride, T(1), weight_deltas, cols);
+    } else {
+      // Only the sum over this batch is formed in T.
+      T* staged = staged_deltas_[layer].Data();
+      kernels::Gemm(false, true, rows, cols, count, T(1), deltas, count,
+                    neurons, stride, T(0), staged, cols);
+      Accumulate(rows * cols, A(1), staged, weight_deltas);
     }
-    layer = layer->outputs.front();
   }
 }
 
-size_t GraphLayers::GetMaxOutputIndex() const noexcept {
-  double max = pre_last_layer_neuron_->outputs.front()->val;
-  size_t max_index = 0;
-  for (size_t row = 1; row < kOutputNeuronsCount; ++row) {
-    double value = pre_last_layer_neuron_->outputs[row]->val;
-    if (value > max) {
-      max = value;
-      max_index = row;
-    }
+template <class T, class A>
+GraphLayers<T, A>::GraphLayers(const std::vector<size_t>& layer_sizes)
+    : Layers<T, A>(layer_sizes) {
+  BuildGraph();
+}
+
+template <class T, class A>
+GraphLayers<T, A>::~GraphLayers() {}
+
+template <class T, class A>
+void GraphLayers<T, A>::BuildGraph() {
+  layer_offsets_.assign(1, 0);
+  for (size_t size : layer_sizes_)
+    layer_offsets_.push_back(layer_offsets_.back() + size);
+  values_.assign(layer_offsets_.back(), T());
+  deltas_.assign(layer_offsets_.back(), T());
+
+  edge_offsets_.assign(1, 0);
+  for (size_t layer = 1; layer + 1 < layer_offsets_.size(); ++layer) {
+    size_t sources_count = layer_offsets_[layer] - layer_offsets_[layer - 1];
+    for (size_t neuron = layer_offsets_[layer];
+         neuron < layer_offsets_[layer + 1]; ++neuron)
+      edge_offsets_.push_back(edge_offsets_.back() + sources_count);
   }
-  return max_index;
 }
 
-void GraphLayers::ChangeNumberOfHiddenLayers(size_t number) {
-  if (number < 2 || number > 5)
-    throw std::runtime_error(
-        "Number of hidden layers should be between 2 and 5");
-  if (number == hidden_layers_count_) return;
-  auto ins = root_0_0_neuron_->outputs.front()->inputs;
-  auto outs = root_0_0_neuron_->outputs;
-  ins.front()->outputs.clear();
-  if (number > hidden_layers_count_) {
-    deltas_for_weights_.insert(deltas_for_weights_.end() - 1,
-                               number - hidden_layers_count_,
-                               S21Matrix<double>(kNeuronsOnHiddenLayerCount));
-
-    deltas_for_biases_.insert(deltas_for_biases_.end() - 1,
-                              number - hidden_layers_count_,
-                              S21Matrix<double>(kNeuronsOnHiddenLayerCount, 1));
-
-    outs.front()->inputs.clear();
-    while (hidden_layers_count_ < number) {
-      for (size_t i = 0; i < kNeuronsOnHiddenLayerCount; ++i)
-        ins.front()->outputs.push_back(new Neuron());
-      for (size_t i = 1; i < ins.size(); ++i)
-        ins[i]->outputs = ins.front()->outputs;
-      for (size_t i = 0; i < ins.front()->outputs.size(); ++i)
-        ins.front()->outputs[i]->inputs = ins;
-      ins = ins.front()->outputs;
-      ++hidden_layers_count_;
-    }
-    for (size_t i = 0; i < kNeuronsOnHiddenLayerCount; ++i) {
-      ins[i]->outputs = outs;
-      outs[i]->inputs = ins;
-    }
-  } else {
-    deltas_for_weights_.erase(
-        deltas_for_weights_.begin() + 1,
-        deltas_for_weights_.begin() + 1 + hidden_layers_count_ - number);
-    deltas_for_biases_.erase(
-        deltas_for_biases_.begin(),
-        deltas_for_biases_.begin() + hidden_layers_count_ - number);
-
-    while (number < hidden_layers_count_) {
-      auto next = outs.front()->outputs;
-      for (size_t i = 0; i < kNeuronsOnHiddenLayerCount; ++i) delete outs[i];
-      outs = next;
-      for (size_t i = 0; i < kNeuronsOnHiddenLayerCount; ++i) {
-        ins[i]->outputs = outs;
-        outs[i]->inputs = ins;
-      }
-      --hidden_layers_count_;
+template <class T, class A>
+void GraphLayers<T, A>::FeedForward(const S21Matrix<T>& image,
+                                    const std::vector<S21Matrix<T>>& weights,
+                                    const std::vector<S21Matrix<T>>& biases) {
+  if (image.GetSize() != GetInputsCount())
+    throw std::runtime_error("Image does not match the input layer");
+  if (weights.size() != hidden_layers_count_ + 1 ||
+      biases.size() != weights.size())
+    throw std::runtime_error("Weights do not match the network");
+  std::copy(image.Data(), image.Data() + GetInputsCount(), values_.begin());
+
+  for (size_t layer = 1; layer < hidden_layers_count_ + 2; ++layer) {
+    const auto& layer_weights = weights[layer - 1];
+    const T* layer_biases = biases[layer - 1].Data();
+    size_t first_source = layer_offsets_[layer - 1];
+    if (layer_weights.GetCols() != layer_offsets_[layer] - first_source ||
+        layer_weights.GetRows() != layer_offsets_[layer + 1] -
+                                       layer_offsets_[layer])
+      throw std::runtime_error("Weights do not match the network");
+    for (size_t neuron = layer_offsets_[layer];
+         neuron < layer_offsets_[layer + 1]; ++neuron) {
+      size_t row = neuron - layer_offsets_[layer];
+      size_t edges = neuron - layer_offsets_[1];
+      values_[neuron] = kernels::Dot(
+          edge_offsets_[edges + 1] - edge_offsets_[edges],
+          layer_weights.Row(row).Data(), values_.data() + first_source);
     }
+    T* layer_values = values_.data() + layer_offsets_[layer];
+    if (layer != hidden_layers_count_ + 1)
+      functions_.ActivateHidden(layer_weights.GetRows(), 1, layer_biases,
+                                layer_values);
+    else
+      functions_.ActivateOutput(layer_weights.GetRows(), 1, layer_biases,
+                                layer_values);
   }
 }
 
-void GraphLayers::BackPropogation(unsigned char expected_result,
-                                  std::vector<S21Matrix<double>>& weights) {
-  auto deltas = deltas_for_biases_;
+template <class T, class A>
+size_t GraphLayers<T, A>::GetMaxOutputIndex() const noexcept {
+  size_t first = layer_offsets_[hidden_layers_count_ + 1];
+  size_t max_index = 0;
+  for (size_t row = 1; row < GetOutputsCount(); ++row)
+    if (values_[first + row] > values_[first + max_index]) max_index = row;
+  return max_index;
+}
 
-  for (size_t row = 0; row < deltas.back().GetRows(); ++row) {
-    auto neuron_value = pre_last_layer_neuron_->outputs[row]->val;
-    double exp_res = 0.0;
-    if (row == static_cast<size_t>(expected_result - 97)) exp_res = 1.0;
-    deltas.back()(row, 0) =
-        Sigmoid::SigmoidDerivative(neuron_value) * (neuron_value - exp_res);
-  }
-  auto cur_layer = pre_last_layer_neuron_;
+template <class T, class A>
+void GraphLayers<T, A>::ChangeLayerSizes(
+    const std::vector<size_t>& layer_sizes) {
+  if (layer_sizes == layer_sizes_) return;
+  Layers<T, A>::ChangeLayerSizes(layer_sizes);
+  BuildGraph();
+}
 
-  for (size_t layer = hidden_layers_count_; layer > 0; --layer) {
-    deltas[layer - 1] = weights[layer].Transpose() * deltas[layer];
-    for (size_t row = 0; row < deltas[layer - 1].GetRows(); ++row) {
-      auto neuron_value = cur_layer->inputs.front()->outputs[row]->val;
-      deltas[layer - 1](row, 0) *= Sigmoid::SigmoidDerivative(neuron_value);
+template <class T, class A>
+void GraphLayers<T, A>::BackPropogation(size_t expected_class,
+                                        std::vector<S21Matrix<T>>& weights) {
+  size_t output_layer = hidden_layers_count_ + 1;
+  size_t first_output = layer_offsets_[output_layer];
+  functions_.ComputeOutputDeltas(GetOutputsCount(), 1,
+                                 values_.data() + first_output,
+                                 &expected_class,
+                                 deltas_.data() + first_output);
+
+  // Deltas flow backwards along the incoming edges of every neuron.
+  for (size_t layer = output_layer; layer > 1; --layer) {
+    const auto& layer_weights = weights[layer - 1];
+    size_t first_source = layer_offsets_[layer - 1];
+    std::fill(deltas_.begin() + first_source,
+              deltas_.begin() + layer_offsets_[layer], T());
+    for (size_t neuron = layer_offsets_[layer];
+         neuron < layer_offsets_[layer + 1]; ++neuron) {
+      size_t row = neuron - layer_offsets_[layer];
+      size_t edges = neuron - layer_offsets_[1];
+      Accumulate(edge_offsets_[edges + 1] - edge_offsets_[edges],
+                 deltas_[neuron], layer_weights.Row(row).Data(),
+                 deltas_.data() + first_source);
     }
-    cur_layer = cur_layer->inputs.front();
+    functions_.ApplyHiddenDerivative(layer_offsets_[layer] - first_source,
+                                     values_.data() + first_source,
+                                     deltas_.data() + first_source);
   }
 
-  for (size_t layer = 0; layer < hidden_layers_count_ + 1; ++layer) {
-    deltas_for_biases_[layer] += deltas[layer];
-    for (size_t row = 0; row < deltas_for_weights_[layer].GetRows(); ++row)
-      for (size_t col = 0; col < deltas_for_weights_[layer].GetCols(); ++col) {
-        deltas_for_weights_[layer](row, col) +=
-            deltas[layer](row, 0) *
-            cur_layer->outputs.front()->inputs[col]->val;
-      }
-    cur_layer = cur_layer->outputs.front();
+  for (size_t layer = 1; layer < output_layer + 1; ++layer) {
+    auto& weight_deltas = deltas_for_weights_[layer - 1];
+    A* bias_deltas = deltas_for_biases_[layer - 1].Data();
+    size_t first_source = layer_offsets_[layer - 1];
+    for (size_t neuron = layer_offsets_[layer];
+         neuron < layer_offsets_[layer + 1]; ++neuron) {
+      size_t row = neuron - layer_offsets_[layer];
+      size_t edges = neuron - layer_offsets_[1];
+      bias_deltas[row] += deltas_[neuron];
+      Accumulate(edge_offsets_[edges + 1] - edge_offsets_[edges],
+                 A(deltas_[neuron]), values_.data() + first_source,
+                 weight_deltas.Row(row).Data());
+    }
   }
 }
 
-double GraphLayers::TotalCost(unsigned char expected_result) const {
-  double sum = 0;
-  for (size_t row = 0; row < kOutputNeuronsCount; ++row) {
-    double value = pre_last_layer_neuron_->outputs[row]->val;
-    if (row == static_cast<size_t>(expected_result - 97)) {
-      sum += (1.0 - value) * (1.0 - value);
-    } else {
-      sum += (0.0 - value) * (0.0 - value);
-    }
-  }
-  return sum / 2.0;
+template <class T, class A>
+double GraphLayers<T, A>::TotalCost(size_t expected_class) const {
+  size_t first = layer_offsets_[hidden_layers_count_ + 1];
+  return functions_.GetLoss(GetOutputsCount(), 1, values_.data() + first, 0,
+                            expected_class);
 }
 
-}  // namespace s21
\ No newline at end of file
+template class Workspace<float>;
+template class Workspace<double>;
+template class Layers<float>;
+template class Layers<double>;
+template class Layers<float, double>;
+template class MatrixLayers<float>;
+template class MatrixLayers<double>;
+template class MatrixLayers<float, double>;
+template class GraphLayers<float>;
+template class GraphLayers<double>;
+template class GraphLayers<float, double>;
+template void Layers<float>::UpdateWeights(std::vector<S21Matrix<float>>&,
+                                           std::vector<S21Matrix<float>>&,
+                                           double);
+template void Layers<float, double>::UpdateWeights(
+    std::vector<S21Matrix<double>>&, std::vector<S21Matrix<double>>&, double);
+template void Layers<double>::UpdateWeights(std::vector<S21Matrix<double>>&,
+                                            std::vector<S21Matrix<double>>&,
+                                            double);
+}  // namespace s21
@@ -1,91 +1,204 @@
 #ifndef CPP7_MLP_MODEL_LAYERS_H_
 #define CPP7_MLP_MODEL_LAYERS_H_
 
+#include <algorithm>
 #include <random>
 #include <vector>
 
+#include "activation.h"
 #include "s21_matrix.h"
-#include "sigmoid.h"
 
 namespace s21 {
+// Preallocated memory of one training step: per-layer activations and
+// deltas for up to GetBatchCapacity() samples (stored row-major with one
+// column per sample) and staging buffers for mini-batch images and labels.
+// Buffers only grow, so steady-state training does not touch the heap.
+template <class T>
+class Workspace {
+ public:
+  void Reserve(const std::vector<size_t>& layer_sizes, size_t batch_capacity);
+  size_t GetBatchCapacity() const noexcept;
+  T* GetActivations(size_t layer) noexcept;
+  const T* GetActivations(size_t layer) const noexcept;
+  T* GetDeltas(size_t layer) noexcept;
+  // A rows x capacity-or-more staging matrix; shorter batches use its
+  // first columns.
+  S21Matrix<T>& GetImages(size_t rows, size_t capacity);
+  // A single rows x 1 image.
+  S21Matrix<T>& GetImage(size_t rows);
+  std::vector<size_t>& GetExpectedClasses() noexcept;
+
+ private:
+  std::vector<T> buffer_;
+  std::vector<size_t> layer_sizes_;
+  std::vector<size_t> activation_offsets_;
+  std::vector<size_t> delta_offsets_;
+  size_t batch_capacity_ = 0;
+  S21Matrix<T> images_;
+  S21Matrix<T> image_;
+  std::vector<size_t> expected_classes_;
+};
+
+// T is the scalar type of weights, activations and deltas, float or double.
+// A is the type the deltas of the weights and biases are summed in across
+// samples and workers: T, or double when T is float, in which case only
+// the sum over one batch of a worker is formed in T.
+// Expected results are class indices, i.e. indices of output neurons.
+template <class T, class A = T>
 class Layers {
  public:
-  explicit Layers(size_t hidden_layers_count);
+  // layer_sizes holds the neuron count of every layer, the input layer
+  // first and the output layer last.
+  explicit Layers(const std::vector<size_t>& layer_sizes);
   Layers(const Layers& layers) = delete;
   Layers(Layers&& layers) = delete;
   Layers& operator=(const Layers& layers) = delete;
   Layers& operator=(Layers&& layers) = delete;
   virtual ~Layers();
 
-  virtual void FeedForward(const S21Matrix<double>& image,
-                           const std::vector<S21Matrix<double>>& weights,
-                           const std::vector<S21Matrix<double>>& biases) = 0;
+  virtual void FeedForward(const S21Matrix<T>& image,
+                           const std::vector<S21Matrix<T>>& weights,
+                           const std::vector<S21Matrix<T>>& biases) = 0;
   virtual size_t GetMaxOutputIndex() const = 0;
-  virtual void ChangeNumberOfHiddenLayers(size_t number) = 0;
-  virtual void BackPropogation(unsigned char expected_result,
-                               std::vector<S21Matrix<double>>& weights) = 0;
-  virtual double TotalCost(unsigned char expected_result) const = 0;
-  void UpdateWeights(std::vector<S21Matrix<double>>& weights,
-                     std::vector<S21Matrix<double>>& biases,
+  virtual void ChangeLayerSizes(const std::vector<size_t>& layer_sizes);
+  virtual void BackPropogation(size_t expected_class,
+                               std::vector<S21Matrix<T>>& weights) = 0;
+  virtual double TotalCost(size_t expected_class) const = 0;
+  // Trains on the first expected_classes.size() columns of images.
+  virtual void TrainMiniBatch(const S21Matrix<T>& images,
+                              const std::vector<size_t>& expected_classes,
+                              std::vector<S21Matrix<T>>& weights,
+                              const std::vector<S21Matrix<T>>& biases,
+                              std::vector<double>& losses);
+  virtual void PredictBatch(const S21Matrix<T>& images,
+                            const std::vector<S21Matrix<T>>& weights,
+                            const std::vector<S21Matrix<T>>& biases,
+                            std::vector<size_t>& predictions);
+  // Applies the accumulated deltas to weights of type W, float or double.
+  template <class W>
+  void UpdateWeights(std::vector<S21Matrix<W>>& weights,
+                     std::vector<S21Matrix<W>>& biases,
                      double learning_rate);
   void ResetDeltas();
+  void AddDeltas(const Layers& other);
   void SetMiniBatchSize(size_t size);
   size_t GetMiniBatchSize() const noexcept;
+  Workspace<T>& GetWorkspace() noexcept;
+  void SetFunctions(const NetworkFunctions& functions) noexcept;
+  const NetworkFunctions& GetFunctions() const noexcept;
+  const std::vector<size_t>& GetLayerSizes() const noexcept;
+  size_t GetInputsCount() const noexcept;
+  size_t GetOutputsCount() const noexcept;
 
-  const size_t kNeuronsOnHiddenLayerCount = 50;
-  const size_t kInputNeuronsCount = 784;
-  const size_t kOutputNeuronsCount = 26;
+  // Throws unless there are at least an input and an output layer and no
+  // layer is empty.
+  static void CheckLayerSizes(const std::vector<size_t>& layer_sizes);
 
  protected:
+  // Copies column col of a batch of images into column_.
+  void CopyColumn(const S21Matrix<T>& images, size_t col);
+
+  std::vector<size_t> layer_sizes_;
   size_t hidden_layers_count_;
   size_t mini_batch_size_ = 32;
-  std::vector<S21Matrix<double>> deltas_for_weights_;
-  std::vector<S21Matrix<double>> deltas_for_biases_;
+  std::vector<S21Matrix<A>> deltas_for_weights_;
+  std::vector<S21Matrix<A>> deltas_for_biases_;
+  // Used only when A differs from T.
+  std::vector<S21Matrix<T>> staged_deltas_;
+  S21Matrix<T> column_;
+  Workspace<T> workspace_;
+  NetworkFunctions functions_;
+
+ private:
+  void AllocateDeltas();
 };
 
-class GraphLayers : public Layers {
+// Graph form of the network: every neuron is a node and every weight is an
+// edge. Neuron values are stored per layer in one contiguous array and the
+// incoming edges of each neuron in CSR form.
+template <class T, class A = T>
+class GraphLayers : public Layers<T, A> {
  public:
-  explicit GraphLayers(size_t hidden_layers_count);
+  explicit GraphLayers(const std::vector<size_t>& layer_sizes);
   ~GraphLayers();
 
-  void FeedForward(const S21Matrix<double>& image,
-                   const std::vector<S21Matrix<double>>& weights,
-                   const std::vector<S21Matrix<double>>& biases) override;
+  void FeedForward(const S21Matrix<T>& image,
+                   const std::vector<S21Matrix<T>>& weights,
+                   const std::vector<S21Matrix<T>>& biases) override;
   size_t GetMaxOutputIndex() const noexcept override;
-  void ChangeNumberOfHiddenLayers(size_t number) override;
-  void BackPropogation(unsigned char expected_result,
-                       std::vector<S21Matrix<double>>& weights) override;
-  double TotalCost(unsigned char expected_result) const override;
+  void ChangeLayerSizes(const std::vector<size_t>& layer_sizes) override;
+  void BackPropogation(size_t expected_class,
+                       std::vector<S21Matrix<T>>& weights) override;
+  double TotalCost(size_t expected_class) const override;
+  using Layers<T, A>::GetInputsCount;
+  using Layers<T, A>::GetOutputsCount;
 
  private:
-  struct Neuron {
-   public:
-    std::vector<Neuron*> inputs;
-    std::vector<Neuron*> outputs;
-    double val;
-    size_t layer;
-  };
-
-  Neuron* root_0_0_neuron_;
-  Neuron* pre_last_layer_neuron_;
+  using Layers<T, A>::layer_sizes_;
+  using Layers<T, A>::hidden_layers_count_;
+  using Layers<T, A>::deltas_for_weights_;
+  using Layers<T, A>::deltas_for_biases_;
+  using Layers<T, A>::functions_;
+
+  void BuildGraph();
+
+  // values_[layer_offsets_[l] + i] is the value of neuron i of layer l, the
+  // input layer being layer 0. deltas_ uses the same layout.
+  std::vector<T> values_;
+  std::vector<T> deltas_;
+  std::vector<size_t> layer_offsets_;
+  // Incoming edges of the n-th non-input neuron are edge_offsets_[n] to
+  // edge_offsets_[n + 1]. Layers are fully connected, so the source of an
+  // edge is implicit: edge - edge_offsets_[n] is its neuron within the
+  // previous layer and its weight matrix column.
+  std::vector<size_t> edge_offsets_;
 };
 
-class MatrixLayers : public Layers {
+template <class T, class A = T>
+class MatrixLayers : public Layers<T, A> {
  public:
-  explicit MatrixLayers(size_t hidden_layers_count);
+  explicit MatrixLayers(const std::vector<size_t>& layer_sizes);
   ~MatrixLayers();
 
-  void FeedForward(const S21Matrix<double>& image,
-                   const std::vector<S21Matrix<double>>& weights,
-                   const std::vector<S21Matrix<double>>& biases) override;
+  void FeedForward(const S21Matrix<T>& image,
+                   const std::vector<S21Matrix<T>>& weights,
+                   const std::vector<S21Matrix<T>>& biases) override;
   size_t GetMaxOutputIndex() const noexcept override;
-  void ChangeNumberOfHiddenLayers(size_t number) override;
-  void BackPropogation(unsigned char expected_result,
-                       std::vector<S21Matrix<double>>& weights) override;
-  double TotalCost(unsigned char expected_result) const override;
+  void BackPropogation(size_t expected_class,
+                       std::vector<S21Matrix<T>>& weights) override;
+  double TotalCost(size_t expected_class) const override;
+  void TrainMiniBatch(const S21Matrix<T>& images,
+                      const std::vector<size_t>& expected_classes,
+                      std::vector<S21Matrix<T>>& weights,
+                      const std::vector<S21Matrix<T>>& biases,
+                      std::vector<double>& losses) override;
+  void PredictBatch(const S21Matrix<T>& images,
+                    const std::vector<S21Matrix<T>>& weights,
+                    const std::vector<S21Matrix<T>>& biases,
+                    std::vector<size_t>& predictions) override;
+  using Layers<T, A>::GetInputsCount;
+  using Layers<T, A>::GetOutputsCount;
 
  private:
-  std::vector<S21Matrix<double>> neurons_;
+  using Layers<T, A>::layer_sizes_;
+  using Layers<T, A>::hidden_layers_count_;
+  using Layers<T, A>::mini_batch_size_;
+  using Layers<T, A>::deltas_for_weights_;
+  using Layers<T, A>::deltas_for_biases_;
+  using Layers<T, A>::staged_deltas_;
+  using Layers<T, A>::workspace_;
+  using Layers<T, A>::functions_;
+
+  // input holds count samples in columns input_stride apart.
+  void FeedForwardBatch(const T* input, size_t input_stride, size_t count,
+                        const std::vector<S21Matrix<T>>& weights,
+                        const std::vector<S21Matrix<T>>& biases);
+  void BackPropogationBatch(const T* input, size_t input_stride,
+                            const size_t* expected_classes, size_t count,
+                            const std::vector<S21Matrix<T>>& weights);
+
+  // Number of samples in the activations of the last forward pass.
+  size_t batch_count_ = 1;
 };
 }  // namespace s21
 #endif  // CPP7_MLP_MODEL_LAYERS_H_
\ No newline at end of file
@@ -0,0 +1,23 @@
+#include "learning_session.h"
+
+namespace s21 {
+template <class T, class Master>
+LearningSession<T, Master>::LearningSession(BasicNetwork<T, Master>& network,
+                                            const std::string& test_path,
+                                            const std::string& mapping_path)
+    : network_(network),
+      test_samples_(Emnist::LoadDataset(test_path, mapping_path,
+                                        network.thread_pool_)) {}
+
+template <class T, class Master>
+NetworkBase::TestResults LearningSession<T, Master>::Evaluate(
+    double average_loss) {
+  auto result = network_.RunTests(test_samples_, 0, test_samples_.GetSize());
+  result.average_loss = average_loss;
+  return result;
+}
+
+template class LearningSession<float, float>;
+template class LearningSession<double, double>;
+template class LearningSession<float, double>;
+}  // namespace s21
@@ -0,0 +1,32 @@
+#ifndef CPP7_MLP_MODEL_LEARNING_SESSION_H_
+#define CPP7_MLP_MODEL_LEARNING_SESSION_H_
+
+#include <string>
+
+#include "network.h"
+#include "sample_store.h"
+
+namespace s21 {
+// State of one StartLearning run. The validation set is parsed once when
+// the session starts and stays resident as a compact SampleStore, so every
+// epoch is evaluated against the cached samples.
+template <class T, class Master>
+class LearningSession {
+ public:
+  LearningSession(BasicNetwork<T, Master>& network,
+                  const std::string& test_path,
+                  const std::string& mapping_path);
+  LearningSession(const LearningSession& other) = delete;
+  LearningSession(LearningSession&& other) = delete;
+  LearningSession& operator=(const LearningSession& other) = delete;
+  LearningSession& operator=(LearningSession&& other) = delete;
+
+  NetworkBase::TestResults Evaluate(double average_loss);
+
+ private:
+  BasicNetwork<T, Master>& network_;
+  SampleStore test_samples_;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_LEARNING_SESSION_H_
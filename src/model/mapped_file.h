@@ -0,0 +1,29 @@
+#ifndef CPP7_MLP_MODEL_MAPPED_FILE_H_
+#define CPP7_MLP_MODEL_MAPPED_FILE_H_
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+namespace s21 {
+// Read-only memory mapping of a whole file. Pages are shared with the page
+// cache, so several processes mapping the same file do not duplicate it.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string& path);
+  MappedFile(const MappedFile& other) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(const MappedFile& other) = delete;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+  ~MappedFile();
+
+  const char* GetData() const noexcept;
+  size_t GetSize() const noexcept;
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_MAPPED_FILE_H_
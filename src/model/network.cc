@@ -1,38 +1,23 @@
 #include "network.h"
 
-namespace s21 {
-Network::~Network() { delete layers; }
-
-Network::Network(NetworkImplementation network_implementation,
-                 size_t hidden_layers_count)
-    : network_implementation_(network_implementation),
-      hidden_layers_count_(hidden_layers_count) {
-  if (network_implementation == NetworkImplementation::kGraphForm)
-    layers = new GraphLayers(hidden_layers_count);
-  else
-    layers = new MatrixLayers(hidden_layers_count);
-
-  weights_.reserve(hidden_layers_count + 1);
-  biases_.reserve(hidden_layers_count + 1);
+#include "learning_session.h"
 
-  weights_.push_back(S21Matrix<double>(layers->kNeuronsOnHiddenLayerCount,
-                                       layers->kInputNeuronsCount));
-  for (size_t i = 0; i < hidden_layers_count; ++i) {
-    if (i != hidden_layers_count - 1)
-      weights_.push_back(S21Matrix<double>(layers->kNeuronsOnHiddenLayerCount));
-    biases_.push_back(S21Matrix<double>(layers->kNeuronsOnHiddenLayerCount, 1));
-  }
-  weights_.push_back(S21Matrix<double>(layers->kOutputNeuronsCount,
-                                       layers->kNeuronsOnHiddenLayerCount));
-  biases_.push_back(S21Matrix<double>(layers->kOutputNeuronsCount, 1));
-
-  std::random_device device;
-  random_gen_.seed(device());
+namespace s21 {
+namespace {
+// Copies source into target, converting the elements to the type of target.
+template <class T, class U>
+void ConvertInto(const S21Matrix<U> &source, S21Matrix<T> &target) {
+  if (target.GetRows() != source.GetRows() ||
+      target.GetCols() != source.GetCols())
+    target = S21Matrix<T>(source.GetRows(), source.GetCols());
+  std::copy(source.Data(), source.Data() + source.GetSize(), target.Data());
 }
+}  // namespace
 
-Network::TestResults::TestResults(double average_accuracy, double precision,
-                                  double recall, double f_measure,
-                                  double total_time, double average_loss)
+NetworkBase::TestResults::TestResults(double average_accuracy,
+                                      double precision, double recall,
+                                      double f_measure, double total_time,
+                                      double average_loss)
     : average_accuracy(average_accuracy),
       precision(precision),
       recall(recall),
@@ -40,165 +25,253 @@ Network::TestResults::TestResults(double average_accuracy, double precision,
       total_time(total_time),
       average_loss(average_loss) {}
 
-void Network::SaveWeightsAndBiases(const std::string &file_name) const {
-  std::ofstream file_stream;
-  file_stream.open(file_name);
-  for (size_t i = 0; i < weights_.size(); ++i) {
-    for (size_t row = 0; row < weights_[i].GetRows(); ++row) {
-      for (size_t col = 0; col < weights_[i].GetCols(); ++col) {
-        file_stream << weights_[i](row, col);
-        if (col != weights_[i].GetCols() - 1) file_stream << ' ';
-      }
-      file_stream << '\n';
-    }
-  }
+std::vector<size_t> NetworkBase::GetDefaultLayerSizes(
+    size_t hidden_layers_count) {
+  std::vector<size_t> layer_sizes(hidden_layers_count + 2,
+                                  kDefaultHiddenLayerSize);
+  layer_sizes.front() = Emnist::kImageSize;
+  layer_sizes.back() = kDefaultClassesCount;
+  return layer_sizes;
+}
 
-  for (size_t i = 0; i < biases_.size(); ++i) {
-    for (size_t row = 0; row < biases_[i].GetRows(); ++row) {
-      file_stream << biases_[i](row, 0);
-      file_stream << '\n';
-    }
-  }
-  if (file_stream.is_open()) file_stream.close();
+template <class T, class Master>
+BasicNetwork<T, Master>::~BasicNetwork() {
+  delete layers;
+  for (auto worker : worker_layers_) delete worker;
 }
 
-bool Network::LoadWeightsAndBiases(const std::string &file_name) {
-  std::ifstream file_stream;
-  file_stream.open(file_name);
-  if (!file_stream.is_open()) return false;
+template <class T, class Master>
+BasicNetwork<T, Master>::BasicNetwork(
+    NetworkImplementation network_implementation, size_t hidden_layers_count)
+    : BasicNetwork(network_implementation,
+                   GetDefaultLayerSizes(hidden_layers_count)) {}
 
-  for (size_t i = 0; i < weights_.size(); ++i) {
-    for (size_t row = 0; row < weights_[i].GetRows(); ++row) {
-      for (size_t col = 0; col < weights_[i].GetCols(); ++col) {
-        if (file_stream.eof()) {
-          file_stream.close();
-          return false;
-        }
-        file_stream >> weights_[i](row, col);
-      }
-    }
-  }
+template <class T, class Master>
+BasicNetwork<T, Master>::BasicNetwork(
+    NetworkImplementation network_implementation,
+    const std::vector<size_t> &layer_sizes)
+    : network_implementation_(network_implementation),
+      layer_sizes_(layer_sizes) {
+  Layers<T>::CheckLayerSizes(layer_sizes);
+  layers = CreateLayers();
+  AllocateWeights();
+  SetLabels(Emnist::GetDefaultLabels(layer_sizes.back()));
 
-  for (size_t i = 0; i < biases_.size(); ++i) {
-    for (size_t row = 0; row < biases_[i].GetRows(); ++row) {
-      if (file_stream.eof()) {
-        file_stream.close();
-        return false;
-      }
-      file_stream >> biases_[i](row, 0);
-    }
-  }
+  std::random_device device;
+  random_gen_.seed(device());
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SaveWeightsAndBiases(
+    const std::string &file_name, WeightsFile::Format format) const {
+  WeightsFile::Save(file_name, weights_, biases_, format, functions_,
+                    labels_);
+}
 
-  if (file_stream.is_open()) file_stream.close();
+template <class T, class Master>
+bool BasicNetwork<T, Master>::LoadWeightsAndBiases(
+    const std::string &file_name) {
+  auto weights = weights_;
+  auto biases = biases_;
+  NetworkFunctions functions = functions_;
+  std::vector<char> labels = labels_;
+  if (!WeightsFile::Load(file_name, weights, biases, &functions, &labels))
+    return false;
+  std::vector<size_t> layer_sizes(1, weights.front().GetCols());
+  for (const auto &layer_weights : weights)
+    layer_sizes.push_back(layer_weights.GetRows());
+  SetLayerSizes(layer_sizes);
+  SetFunctions(functions);
+  SetLabels(labels.empty() ? Emnist::GetDefaultLabels(layer_sizes.back())
+                           : std::move(labels));
+  weights_ = std::move(weights);
+  biases_ = std::move(biases);
+  SyncComputeWeights();
+  ResetInferenceModel();
   trained = true;
   return true;
 }
 
-void Network::ChangeImplenetation(
+template <class T, class Master>
+void BasicNetwork<T, Master>::ChangeImplenetation(
     NetworkImplementation network_implementation) {
   if (network_implementation == network_implementation_) return;
-  delete layers;
-  if (network_implementation == NetworkImplementation::kGraphForm)
-    layers = new GraphLayers(hidden_layers_count_);
-  else
-    layers = new MatrixLayers(hidden_layers_count_);
+  size_t mini_batch_size = layers->GetMiniBatchSize();
   network_implementation_ = network_implementation;
+  delete layers;
+  layers = CreateLayers();
+  layers->SetMiniBatchSize(mini_batch_size);
+  for (auto& worker : worker_layers_) {
+    delete worker;
+    worker = CreateLayers();
+    worker->SetMiniBatchSize(mini_batch_size);
+  }
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::ChangeHiddenLayersNumber(size_t number) {
+  size_t hidden_layer_size = layer_sizes_.size() > 2
+                                 ? layer_sizes_[layer_sizes_.size() - 2]
+                                 : kDefaultHiddenLayerSize;
+  std::vector<size_t> layer_sizes(number + 2, hidden_layer_size);
+  layer_sizes.front() = layer_sizes_.front();
+  layer_sizes.back() = layer_sizes_.back();
+  SetLayerSizes(layer_sizes);
 }
 
-void Network::ChangeHiddenLayersNumber(size_t number) {
-  if (number == hidden_layers_count_) return;
-  layers->ChangeNumberOfHiddenLayers(number);
-  if (number > hidden_layers_count_) {
-    weights_.insert(weights_.end() - 1, number - hidden_layers_count_,
-                    S21Matrix<double>(layers->kNeuronsOnHiddenLayerCount));
-    biases_.insert(biases_.end() - 1, number - hidden_layers_count_,
-                   S21Matrix<double>(layers->kNeuronsOnHiddenLayerCount, 1));
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetLayerSizes(
+    const std::vector<size_t> &layer_sizes) {
+  if (layer_sizes == layer_sizes_) return;
+  Layers<T>::CheckLayerSizes(layer_sizes);
+  layers->ChangeLayerSizes(layer_sizes);
+  for (auto worker : worker_layers_) worker->ChangeLayerSizes(layer_sizes);
+  layer_sizes_ = layer_sizes;
+  AllocateWeights();
+  if (labels_.size() != layer_sizes.back())
+    SetLabels(Emnist::GetDefaultLabels(layer_sizes.back()));
+  trained = false;
+  ResetInferenceModel();
+}
+
+template <class T, class Master>
+const std::vector<size_t> &BasicNetwork<T, Master>::GetLayerSizes()
+    const noexcept {
+  return layer_sizes_;
+}
+
+template <class T, class Master>
+const std::vector<char> &BasicNetwork<T, Master>::GetLabels() const noexcept {
+  return labels_;
+}
+
+template <class T, class Master>
+char BasicNetwork<T, Master>::GetPrediction(
+    const S21Matrix<double> &image) const {
+  auto inference_model = GetInferenceModel();
+  if constexpr (std::is_same_v<T, double>) {
+    return inference_model->GetLabel(inference_model->Predict(image));
   } else {
-    weights_.erase(weights_.begin() + 1,
-                   weights_.begin() + 1 + hidden_layers_count_ - number);
-    biases_.erase(biases_.begin(),
-                  biases_.begin() + hidden_layers_count_ - number);
+    return inference_model->GetLabel(
+        inference_model->Predict(S21Matrix<T>(image)));
   }
-  hidden_layers_count_ = number;
-  trained = false;
 }
 
-char Network::GetPrediction(const S21Matrix<double> &image) const {
+template <class T, class Master>
+std::vector<InferenceModelBase::Classification>
+BasicNetwork<T, Master>::ClassifyBatch(const uint8_t *pixels,
+                                       size_t images_count,
+                                       size_t top_k) const {
+  return GetInferenceModel()->ClassifyBatch(pixels, images_count, top_k);
+}
+
+template <class T, class Master>
+std::shared_ptr<const InferenceModel<T>>
+BasicNetwork<T, Master>::GetInferenceModel() const {
   if (!trained) throw std::runtime_error("Network is not trained");
-  layers->FeedForward(image, weights_, biases_);
-  return 97 + layers->GetMaxOutputIndex();
+  std::lock_guard<std::mutex> lock(inference_model_mutex_);
+  if (!inference_model_)
+    inference_model_ = std::make_shared<const InferenceModel<T>>(
+        GetComputeWeights(), GetComputeBiases(), labels_, functions_,
+        static_inference_);
+  return inference_model_;
 }
 
-typename Network::TestResults Network::RunTests(const std::string &data_path,
-                                                const std::string &mapping_path,
-                                                double sample_part) {
+template <class T, class Master>
+NetworkBase::TestResults BasicNetwork<T, Master>::RunTests(
+    const std::string &data_path, const std::string &mapping_path,
+    double sample_part) {
   if (sample_part < 0.0 || sample_part > 1.0)
     throw std::runtime_error(
         "Sample part should be a number between 0.0 and 1.0");
-  auto samples = Emnist::LoadDataset(data_path, mapping_path);
+  auto samples = Emnist::LoadDataset(data_path, mapping_path, thread_pool_);
 
-  std::shuffle(samples.begin(), samples.end(), random_gen_);
-  size_t last_el_index = samples.size() * sample_part;
-  auto result = RunTests(samples.begin(), samples.begin() + last_el_index);
+  samples.Shuffle(random_gen_);
+  size_t last_el_index = samples.GetSize() * sample_part;
+  auto result = RunTests(samples, 0, last_el_index);
   return result;
 }
 
-std::vector<Network::TestResults> Network::StartLearning(
+template <class T, class Master>
+std::vector<NetworkBase::TestResults> BasicNetwork<T, Master>::StartLearning(
     const std::string &data_path, const std::string &test_path,
     const std::string &mapping_path, size_t epochs_count) {
   if (epochs_count == 0) throw std::runtime_error("Invalid number of epochs");
+  LoadLabels(mapping_path);
   trained = true;
   InitWeights();
   std::vector<TestResults> result;
   result.reserve(epochs_count);
 
-  auto samples = Emnist::LoadDataset(data_path, mapping_path);
+  auto samples = Emnist::LoadDataset(data_path, mapping_path, thread_pool_);
+  LearningSession<T, Master> session(*this, test_path, mapping_path);
 
   for (size_t epoch = 0; epoch < epochs_count; ++epoch) {
-    std::shuffle(samples.begin(), samples.end(), random_gen_);
+    samples.Shuffle(random_gen_);
     auto losses = Train(samples, epoch, epochs_count);
-    auto test_result = RunTests(test_path, mapping_path, 1);
-    test_result.average_loss =
-        std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
-    result.push_back(test_result);
+    result.push_back(session.Evaluate(
+        std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size()));
+  }
+  return result;
+}
+
+template <class T, class Master>
+std::vector<NetworkBase::TestResults>
+BasicNetwork<T, Master>::StartLearningStreaming(
+    const std::string &data_path, const std::string &test_path,
+    const std::string &mapping_path, size_t epochs_count,
+    size_t shuffle_buffer_size) {
+  if (epochs_count == 0) throw std::runtime_error("Invalid number of epochs");
+  auto source = DataSource::Open(data_path, mapping_path);
+  LoadLabels(mapping_path);
+  trained = true;
+  InitWeights();
+  std::vector<TestResults> result;
+  result.reserve(epochs_count);
+  LearningSession<T, Master> session(*this, test_path, mapping_path);
+
+  size_t mini_batch_size = layers->GetMiniBatchSize();
+  size_t block_size = std::max(kStreamBlockSize / mini_batch_size, size_t(1)) *
+                      mini_batch_size;
+  for (size_t epoch = 0; epoch < epochs_count; ++epoch) {
+    SampleStream stream(*source, shuffle_buffer_size, block_size,
+                        random_gen_());
+    SampleStore block;
+    double loss_sum = 0;
+    size_t loss_count = 0;
+    while (stream.Next(block)) {
+      auto losses = Train(block, epoch, epochs_count);
+      loss_sum += std::accumulate(losses.begin(), losses.end(), 0.0);
+      loss_count += losses.size();
+    }
+    result.push_back(session.Evaluate(loss_sum / loss_count));
   }
   return result;
 }
 
-std::vector<Network::TestResults> Network::StartLearningWithCrossValidation(
-    const std::string &data_path, const std::string &mapping_path, size_t k) {
+template <class T, class Master>
+std::vector<NetworkBase::TestResults>
+BasicNetwork<T, Master>::StartLearningWithCrossValidation(
+    const std::string &data_path, const std::string &mapping_path, size_t k,
+    bool independent_folds) {
   if (k < 5 || k > 10) throw std::runtime_error("Invalid number of gropus");
+  LoadLabels(mapping_path);
   trained = true;
+  auto samples = Emnist::LoadDataset(data_path, mapping_path, thread_pool_);
+  samples.Shuffle(random_gen_);
+  if (independent_folds) return RunIndependentFolds(samples, k);
+
   InitWeights();
   std::vector<TestResults> result;
   result.reserve(k);
-  auto samples = Emnist::LoadDataset(data_path, mapping_path);
-  std::shuffle(samples.begin(), samples.end(), random_gen_);
-  size_t group_size = samples.size() / k;
+  size_t group_size = samples.GetSize() / k;
   for (size_t group = 0; group < k; ++group) {
-    std::vector<Emnist::Dataset> train_samples;
-    std::vector<Emnist::Dataset> test_samples;
-    if (group != k - 1) {
-      test_samples.reserve(group_size);
-      test_samples.insert(test_samples.end(),
-                          samples.begin() + group * group_size,
-                          samples.begin() + (group + 1) * group_size);
-      train_samples.reserve(samples.size() - test_samples.size());
-      train_samples.insert(train_samples.end(), samples.begin(),
-                           samples.begin() + group * group_size);
-      train_samples.insert(train_samples.end(),
-                           samples.begin() + (group + 1) * group_size,
-                           samples.end());
-    } else {
-      test_samples.reserve(samples.size() - group * group_size);
-      test_samples.insert(test_samples.end(),
-                          samples.begin() + group * group_size, samples.end());
-      train_samples.reserve(samples.size() - test_samples.size());
-      train_samples.insert(train_samples.end(), samples.begin(),
-                           samples.begin() + group * group_size);
-    }
+    size_t begin = group * group_size;
+    size_t end = group != k - 1 ? begin + group_size : samples.GetSize();
+    auto train_samples = samples.Exclude(begin, end);
+    auto test_samples = samples.Select(begin, end);
     auto losses = Train(train_samples, group, k);
-    auto test_result = RunTests(test_samples.begin(), test_samples.end());
+    auto test_result = RunTests(test_samples, 0, test_samples.GetSize());
     test_result.average_loss =
         std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
     result.push_back(test_result);
@@ -206,17 +279,137 @@ std::vector<Network::TestResults> Network::StartLearningWithCrossValidation(
   return result;
 }
 
-size_t Network::GetMiniBatchSize() const noexcept {
+template <class T, class Master>
+size_t BasicNetwork<T, Master>::GetMiniBatchSize() const noexcept {
   return layers->GetMiniBatchSize();
 }
 
-void Network::SetMiniBatchSize(size_t size) { layers->SetMiniBatchSize(size); }
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetMiniBatchSize(size_t size) {
+  layers->SetMiniBatchSize(size);
+  for (auto worker : worker_layers_) worker->SetMiniBatchSize(size);
+}
+
+template <class T, class Master>
+bool BasicNetwork<T, Master>::GetBatchedTraining() const noexcept {
+  return batched_training_;
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetBatchedTraining(bool batched) {
+  batched_training_ = batched;
+}
+
+template <class T, class Master>
+bool BasicNetwork<T, Master>::GetStaticInference() const noexcept {
+  return static_inference_;
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetStaticInference(bool enabled) {
+  static_inference_ = enabled;
+  ResetInferenceModel();
+}
+
+template <class T, class Master>
+size_t BasicNetwork<T, Master>::GetThreadsCount() const noexcept {
+  return thread_pool_.GetThreadsCount();
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetThreadsCount(size_t threads_count) {
+  thread_pool_.SetThreadsCount(threads_count);
+  while (worker_layers_.size() + 1 > threads_count) {
+    delete worker_layers_.back();
+    worker_layers_.pop_back();
+  }
+  while (worker_layers_.size() + 1 < threads_count) {
+    worker_layers_.push_back(CreateLayers());
+    worker_layers_.back()->SetMiniBatchSize(layers->GetMiniBatchSize());
+  }
+}
+
+template <class T, class Master>
+const NetworkFunctions& BasicNetwork<T, Master>::GetFunctions()
+    const noexcept {
+  return functions_;
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetFunctions(
+    const NetworkFunctions& functions) {
+  if (functions == functions_) return;
+  functions_ = functions;
+  layers->SetFunctions(functions);
+  for (auto worker : worker_layers_) worker->SetFunctions(functions);
+  trained = false;
+  ResetInferenceModel();
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::ResetInferenceModel() {
+  std::lock_guard<std::mutex> lock(inference_model_mutex_);
+  inference_model_.reset();
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::AllocateWeights() {
+  weights_.clear();
+  biases_.clear();
+  for (size_t layer = 0; layer + 1 < layer_sizes_.size(); ++layer) {
+    weights_.push_back(
+        S21Matrix<Master>(layer_sizes_[layer + 1], layer_sizes_[layer]));
+    biases_.push_back(S21Matrix<Master>(layer_sizes_[layer + 1], 1));
+  }
+  SyncComputeWeights();
+}
+
+template <class T, class Master>
+std::vector<S21Matrix<T>> &
+BasicNetwork<T, Master>::GetComputeWeights() noexcept {
+  if constexpr (std::is_same_v<T, Master>)
+    return weights_;
+  else
+    return compute_weights_;
+}
+
+template <class T, class Master>
+const std::vector<S21Matrix<T>> &BasicNetwork<T, Master>::GetComputeWeights()
+    const noexcept {
+  if constexpr (std::is_same_v<T, Master>)
+    return weights_;
+  else
+    return compute_weights_;
+}
+
+template <class T, class Master>
+const std::vector<S21Matrix<T>> &BasicNetwork<T, Master>::GetComputeBiases()
+    const noexcept {
+  if constexpr (std::is_same_v<T, Master>)
+    return biases_;
+  else
+    return compute_biases_;
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::SyncComputeWeights() {
+  if constexpr (!std::is_same_v<T, Master>) {
+    compute_weights_.resize(weights_.size());
+    compute_biases_.resize(biases_.size());
+    for (size_t layer = 0; layer < weights_.size(); ++layer) {
+      ConvertInto(weights_[layer], compute_weights_[layer]);
+      ConvertInto(biases_[layer], compute_biases_[layer]);
+    }
+  }
+}
 
-void Network::InitWeights() {
+template <class T, class Master>
+void BasicNetwork<T, Master>::InitWeights() {
+  ResetInferenceModel();
   for (size_t i = 0; i < weights_.size(); ++i) {
-    std::uniform_real_distribution<> dist_w(
-        -(sqrt(6) / sqrt(weights_[i].GetCols() + weights_[i].GetRows())),
-        sqrt(6) / sqrt(weights_[i].GetCols() + weights_[i].GetRows()));
+    double range = functions_.GetInitRange(
+        weights_[i].GetCols(), weights_[i].GetRows(), i + 1 == weights_.size());
+    std::uniform_real_distribution<> dist_w(-range, range);
     std::uniform_real_distribution<> dist_b(
         -(sqrt(6) / sqrt(biases_[i].GetCols() + biases_[i].GetRows())),
         sqrt(6) / sqrt(biases_[i].GetCols() + biases_[i].GetRows()));
@@ -226,71 +419,251 @@ void Network::InitWeights() {
         weights_[i](row, col) = dist_w(random_gen_);
     }
   }
+  SyncComputeWeights();
 }
 
-Network::TestResults Network::RunTests(
-    std::vector<Emnist::Dataset>::iterator start,
-    std::vector<Emnist::Dataset>::iterator end) {
-  S21Matrix<size_t> confusion_matrix(layers->kOutputNeuronsCount);
-  size_t correct_guesses = 0;
+template <class T, class Master>
+Layers<T, Master> *BasicNetwork<T, Master>::CreateLayers() const {
+  Layers<T, Master> *result;
+  if (network_implementation_ == NetworkImplementation::kGraphForm)
+    result = new GraphLayers<T, Master>(layer_sizes_);
+  else
+    result = new MatrixLayers<T, Master>(layer_sizes_);
+  result->SetFunctions(functions_);
+  return result;
+}
 
-  auto clock_start = std::chrono::high_resolution_clock::now();
-  for (auto sample = start; sample < end; ++sample) {
-    auto prediction = GetPrediction(sample->imageData);
-    auto expected_result = sample->lowerCaseLetter;
-    if (prediction == expected_result) ++correct_guesses;
-    ++confusion_matrix(prediction - 97, expected_result - 97);
+template <class T, class Master>
+void BasicNetwork<T, Master>::SetLabels(std::vector<char> labels) {
+  labels_ = std::move(labels);
+  label_classes_.fill(kNoClass);
+  for (size_t output = 0; output < labels_.size(); ++output) {
+    size_t &label_class =
+        label_classes_[static_cast<unsigned char>(labels_[output])];
+    if (label_class == kNoClass) label_class = output;
+  }
+  ResetInferenceModel();
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::LoadLabels(const std::string &mapping_path) {
+  Emnist::Mapping mapping;
+  if (!Emnist::LoadMapping(mapping_path, mapping))
+    throw std::runtime_error("Unable to open mapping file " + mapping_path);
+  auto labels = Emnist::GetLabels(mapping);
+  if (labels.size() != layer_sizes_.back())
+    throw std::runtime_error(
+        "Mapping has " + std::to_string(labels.size()) +
+        " classes but the output layer " +
+        std::to_string(layer_sizes_.back()) + " neurons");
+  SetLabels(std::move(labels));
+}
+
+template <class T, class Master>
+size_t BasicNetwork<T, Master>::GetClass(const SampleStore &samples,
+                                         size_t position) const {
+  size_t expected_class = label_classes_[static_cast<unsigned char>(
+      samples.GetLowerCaseLetter(position))];
+  if (expected_class == kNoClass)
+    throw std::runtime_error("Sample label is not a class of the network");
+  return expected_class;
+}
+
+template <class T, class Master>
+Layers<T, Master> *BasicNetwork<T, Master>::GetWorkerLayers(
+    size_t worker) const {
+  return worker == 0 ? layers : worker_layers_[worker - 1];
+}
+
+template <class T, class Master>
+void BasicNetwork<T, Master>::ReduceDeltas() {
+  size_t workers_count = worker_layers_.size() + 1;
+  for (size_t stride = 1; stride < workers_count; stride *= 2) {
+    size_t pairs = (workers_count - stride + 2 * stride - 1) / (2 * stride);
+    thread_pool_.Run(pairs, [this, stride](size_t pair) {
+      size_t target = pair * 2 * stride;
+      GetWorkerLayers(target)->AddDeltas(*GetWorkerLayers(target + stride));
+    });
   }
+}
+
+template <class T, class Master>
+std::vector<NetworkBase::TestResults>
+BasicNetwork<T, Master>::RunIndependentFolds(const SampleStore &samples,
+                                             size_t k) {
+  std::vector<TestResults> result(k, TestResults(0, 0, 0, 0, 0));
+  std::vector<std::unique_ptr<BasicNetwork>> replicas(k);
+  size_t group_size = samples.GetSize() / k;
+  thread_pool_.Run(k, [&](size_t group) {
+    replicas[group] =
+        std::make_unique<BasicNetwork>(network_implementation_, layer_sizes_);
+    BasicNetwork &replica = *replicas[group];
+    replica.SetMiniBatchSize(layers->GetMiniBatchSize());
+    replica.SetBatchedTraining(batched_training_);
+    replica.SetFunctions(functions_);
+    replica.SetLabels(labels_);
+    replica.trained = true;
+    replica.InitWeights();
+    size_t begin = group * group_size;
+    size_t end = group != k - 1 ? begin + group_size : samples.GetSize();
+    auto losses = replica.Train(samples.Exclude(begin, end), 0, 1);
+    auto test_samples = samples.Select(begin, end);
+    result[group] = replica.RunTests(test_samples, 0, test_samples.GetSize());
+    result[group].average_loss =
+        std::accumulate(losses.begin(), losses.end(), 0.0) / losses.size();
+  });
+
+  size_t best = 0;
+  for (size_t group = 1; group < k; ++group)
+    if (result[group].average_accuracy > result[best].average_accuracy)
+      best = group;
+  weights_ = std::move(replicas[best]->weights_);
+  biases_ = std::move(replicas[best]->biases_);
+  SyncComputeWeights();
+  ResetInferenceModel();
+  return result;
+}
+
+template <class T, class Master>
+NetworkBase::TestResults BasicNetwork<T, Master>::RunTests(
+    const SampleStore &samples, size_t begin, size_t end) {
+  if (!trained) throw std::runtime_error("Network is not trained");
+  size_t workers_count = worker_layers_.size() + 1;
+  std::vector<S21Matrix<size_t>> confusion_matrices(
+      workers_count, S21Matrix<size_t>(layers->GetOutputsCount()));
+  size_t samples_count = end - begin;
+
+  auto clock_start = std::chrono::high_resolution_clock::now();
+  thread_pool_.Run(workers_count, [&](size_t worker) {
+    size_t first = begin + samples_count * worker / workers_count;
+    size_t last = begin + samples_count * (worker + 1) / workers_count;
+    TestSamples(GetWorkerLayers(worker), samples, first, last,
+                confusion_matrices[worker]);
+  });
+  S21Matrix<size_t> confusion_matrix = confusion_matrices.front();
+  for (size_t worker = 1; worker < workers_count; ++worker)
+    confusion_matrix += confusion_matrices[worker];
+  size_t correct_guesses = 0;
+  for (size_t i = 0; i < layers->GetOutputsCount(); ++i)
+    correct_guesses += confusion_matrix(i, i);
   auto clock_end = std::chrono::high_resolution_clock::now();
 
   double precision = 0;
   double recall = 0;
 
-  for (size_t i = 0; i < layers->kOutputNeuronsCount; ++i) {
+  for (size_t i = 0; i < layers->GetOutputsCount(); ++i) {
     double diag_el = confusion_matrix(i, i);
     double col_sum = 0;
     double row_sum = 0;
-    for (size_t j = 0; j < layers->kOutputNeuronsCount; ++j) {
+    for (size_t j = 0; j < layers->GetOutputsCount(); ++j) {
       row_sum += confusion_matrix(i, j);
       col_sum += confusion_matrix(j, i);
     }
     if (fabs(row_sum - 0.0) > 1e-6) precision += diag_el / row_sum;
     if (fabs(col_sum - 0.0) > 1e-6) recall += diag_el / col_sum;
   }
-  precision /= layers->kOutputNeuronsCount;
-  recall /= layers->kOutputNeuronsCount;
+  precision /= layers->GetOutputsCount();
+  recall /= layers->GetOutputsCount();
   double f_measure = 2 * (precision * recall) / (precision + recall);
 
-  Network::TestResults test_results(
-      correct_guesses / static_cast<double>(std::distance(start, end)),
+  TestResults test_results(
+      correct_guesses / static_cast<double>(samples_count),
       precision, recall, f_measure,
       std::chrono::duration_cast<std::chrono::seconds>(clock_end - clock_start)
           .count());
   return test_results;
 }
 
-std::vector<double> Network::Train(std::vector<Emnist::Dataset> &samples,
-                                   size_t iteration, size_t iterations_count) {
-  size_t mini_batch_size = layers->GetMiniBatchSize();
-  std::vector<double> losses;
-  size_t samples_size = samples.size();
-  losses.reserve(samples_size);
+template <class T, class Master>
+void BasicNetwork<T, Master>::TestSamples(
+    Layers<T, Master> *worker, const SampleStore &samples, size_t begin,
+    size_t end, S21Matrix<size_t> &confusion_matrix) const {
+  std::vector<size_t> predictions;
+  predictions.reserve(kTestBatchSize);
+  S21Matrix<T> images(worker->GetInputsCount(), kTestBatchSize);
+  while (begin < end) {
+    size_t count = std::min(kTestBatchSize, end - begin);
+    if (images.GetCols() != count)
+      images = S21Matrix<T>(worker->GetInputsCount(), count);
+    samples.Gather(begin, count, images);
+    predictions.clear();
+    worker->PredictBatch(images, GetComputeWeights(), GetComputeBiases(),
+                         predictions);
+    for (size_t col = 0; col < count; ++col)
+      ++confusion_matrix(predictions[col], GetClass(samples, begin + col));
+    begin += count;
+  }
+}
 
-  size_t sample = 0;
-  while (sample < samples_size) {
-    for (size_t mini_batch_sample = 0;
-         sample < samples_size && mini_batch_sample < mini_batch_size;
-         ++mini_batch_sample, ++sample) {
-      layers->FeedForward(samples[sample].imageData, weights_, biases_);
-      layers->BackPropogation(samples[sample].lowerCaseLetter, weights_);
-      losses.push_back(layers->TotalCost(samples[sample].lowerCaseLetter));
-    }
+template <class T, class Master>
+std::vector<double> BasicNetwork<T, Master>::Train(const SampleStore &samples,
+                                                   size_t iteration,
+                                                   size_t iterations_count) {
+  size_t mini_batch_size = layers->GetMiniBatchSize();
+  size_t samples_size = samples.GetSize();
+  size_t workers_count = worker_layers_.size() + 1;
+  std::vector<std::vector<double>> worker_losses(workers_count);
+  for (auto &losses : worker_losses)
+    losses.reserve(samples_size / workers_count + mini_batch_size);
+
+  for (size_t start = 0; start < samples_size; start += mini_batch_size) {
+    size_t count = std::min(mini_batch_size, samples_size - start);
+    thread_pool_.Run(workers_count, [&](size_t worker) {
+      size_t begin = start + count * worker / workers_count;
+      size_t end = start + count * (worker + 1) / workers_count;
+      if (begin != end)
+        TrainSamples(GetWorkerLayers(worker), samples, begin, end,
+                     worker_losses[worker]);
+    });
+    ReduceDeltas();
     layers->UpdateWeights(
         weights_, biases_,
         0.99 * exp(-(static_cast<double>(iteration) / iterations_count)));
-    layers->ResetDeltas();
+    SyncComputeWeights();
+    ResetInferenceModel();
+    thread_pool_.Run(workers_count, [this](size_t worker) {
+      GetWorkerLayers(worker)->ResetDeltas();
+    });
   }
+
+  std::vector<double> losses;
+  losses.reserve(samples_size);
+  for (const auto &worker : worker_losses)
+    losses.insert(losses.end(), worker.begin(), worker.end());
   return losses;
 }
 
-}  // namespace s21
\ No newline at end of file
+template <class T, class Master>
+void BasicNetwork<T, Master>::TrainSamples(Layers<T, Master> *worker,
+                                           const SampleStore &samples,
+                                           size_t begin, size_t end,
+                                           std::vector<double> &losses) {
+  Workspace<T> &workspace = worker->GetWorkspace();
+  std::vector<S21Matrix<T>> &weights = GetComputeWeights();
+  const std::vector<S21Matrix<T>> &biases = GetComputeBiases();
+  if (!batched_training_) {
+    S21Matrix<T> &image = workspace.GetImage(worker->GetInputsCount());
+    for (size_t sample = begin; sample < end; ++sample) {
+      samples.GetImage(sample, image);
+      worker->FeedForward(image, weights, biases);
+      size_t expected_class = GetClass(samples, sample);
+      worker->BackPropogation(expected_class, weights);
+      losses.push_back(worker->TotalCost(expected_class));
+    }
+    return;
+  }
+
+  S21Matrix<T> &images = workspace.GetImages(
+      worker->GetInputsCount(), std::max(end - begin, GetMiniBatchSize()));
+  std::vector<size_t> &expected_classes = workspace.GetExpectedClasses();
+  expected_classes.clear();
+  samples.Gather(begin, end - begin, images);
+  for (size_t sample = begin; sample < end; ++sample)
+    expected_classes.push_back(GetClass(samples, sample));
+  worker->TrainMiniBatch(images, expected_classes, weights, biases, losses);
+}
+
+template class BasicNetwork<float>;
+template class BasicNetwork<double>;
+template class BasicNetwork<float, double>;
+}  // namespace s21
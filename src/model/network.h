@@ -2,20 +2,31 @@
 #define CPP7_MLP_MODEL_NETWORK_H_
 
 #include <algorithm>
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <cstring>
 #include <fstream>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <random>
 #include <vector>
 
+#include "data_source.h"
 #include "emnist.h"
+#include "inference_model.h"
 #include "layers.h"
 #include "s21_matrix.h"
+#include "thread_pool.h"
+#include "weights_file.h"
 
 namespace s21 {
+template <class T, class Master>
+class LearningSession;
 
-class Network {
+// Types and defaults shared by networks of every precision.
+class NetworkBase {
  public:
   struct TestResults {
    public:
@@ -30,47 +41,144 @@ class Network {
     double average_loss;
   };
 
+  static constexpr size_t kDefaultShuffleBufferSize = 65536;
+  static constexpr size_t kDefaultHiddenLayerSize = 50;
+  static constexpr size_t kDefaultClassesCount = 26;
+
   enum class NetworkImplementation { kMatrixForm = 0, kGraphForm = 1 };
 
-  explicit Network(NetworkImplementation network_implementationl,
-                   size_t hidden_layers_count);
-  Network(const Network& network) = delete;
-  Network(Network&& network) = delete;
-  Network& operator=(const Network& network) = delete;
-  Network& operator=(Network&& network) = delete;
-  ~Network();
+ protected:
+  static std::vector<size_t> GetDefaultLayerSizes(size_t hidden_layers_count);
+};
+
+// T is the scalar type the layers compute in and Master the type of the
+// weights the network updates and saves. BasicNetwork<float> runs in float
+// end to end; BasicNetwork<float, double> computes in float, sums the
+// gradients of a mini-batch across samples and workers in double and
+// applies them to double weights, which are copied to float for the next
+// mini-batch. Inference runs in T on the weights the layers compute with.
+template <class T, class Master = T>
+class BasicNetwork : public NetworkBase {
+  friend LearningSession<T, Master>;
 
-  void SaveWeightsAndBiases(const std::string& file_name) const;
+ public:
+  // Hidden layers of kDefaultHiddenLayerSize neurons between EMNIST images
+  // and kDefaultClassesCount classes.
+  explicit BasicNetwork(NetworkImplementation network_implementationl,
+                        size_t hidden_layers_count);
+  // layer_sizes holds the neuron count of every layer, the input layer
+  // first. Output neuron i stands for Emnist::GetDefaultLabels()[i] until
+  // training or a weights file sets the labels.
+  BasicNetwork(NetworkImplementation network_implementation,
+               const std::vector<size_t>& layer_sizes);
+  BasicNetwork(const BasicNetwork& network) = delete;
+  BasicNetwork(BasicNetwork&& network) = delete;
+  BasicNetwork& operator=(const BasicNetwork& network) = delete;
+  BasicNetwork& operator=(BasicNetwork&& network) = delete;
+  ~BasicNetwork();
+
+  void SaveWeightsAndBiases(
+      const std::string& file_name,
+      WeightsFile::Format format = WeightsFile::Format::kBinary) const;
+  // Binary weights files also set the layer sizes, the functions and the
+  // labels.
   bool LoadWeightsAndBiases(const std::string& file_name);
   void ChangeImplenetation(NetworkImplementation network_implementation);
+  // Keeps the width of the last hidden layer for every hidden layer.
   void ChangeHiddenLayersNumber(size_t number);
+  // Changing the layer sizes discards the trained state.
+  void SetLayerSizes(const std::vector<size_t>& layer_sizes);
+  const std::vector<size_t>& GetLayerSizes() const noexcept;
+  // Label of every output neuron. Training takes them from the mapping,
+  // whose classes must match the output layer.
+  const std::vector<char>& GetLabels() const noexcept;
   char GetPrediction(const S21Matrix<double>& image) const;
+  std::shared_ptr<const InferenceModel<T>> GetInferenceModel() const;
+  std::vector<InferenceModelBase::Classification> ClassifyBatch(
+      const uint8_t* pixels, size_t images_count, size_t top_k) const;
   TestResults RunTests(const std::string& data_path,
                        const std::string& mapping_path, double sample_part);
   std::vector<TestResults> StartLearning(const std::string& data_path,
                                          const std::string& test_path,
                                          const std::string& mapping_path,
                                          size_t epochs_count);
+  std::vector<TestResults> StartLearningStreaming(
+      const std::string& data_path, const std::string& test_path,
+      const std::string& mapping_path, size_t epochs_count,
+      size_t shuffle_buffer_size = kDefaultShuffleBufferSize);
   std::vector<TestResults> StartLearningWithCrossValidation(
-      const std::string& data_path, const std::string& mapping_path, size_t k);
+      const std::string& data_path, const std::string& mapping_path, size_t k,
+      bool independent_folds = false);
   size_t GetMiniBatchSize() const noexcept;
   void SetMiniBatchSize(size_t size);
+  bool GetBatchedTraining() const noexcept;
+  void SetBatchedTraining(bool batched);
+  // Whether inference runs single images through a network compiled for
+  // the topology when there is one (see StaticEngine).
+  bool GetStaticInference() const noexcept;
+  void SetStaticInference(bool enabled);
+  size_t GetThreadsCount() const noexcept;
+  void SetThreadsCount(size_t threads_count);
+  const NetworkFunctions& GetFunctions() const noexcept;
+  // Changing the functions discards the trained state.
+  void SetFunctions(const NetworkFunctions& functions);
 
  private:
+  void AllocateWeights();
+  // Weights the layers compute with: weights_ and biases_ themselves or
+  // their copies in T.
+  std::vector<S21Matrix<T>>& GetComputeWeights() noexcept;
+  const std::vector<S21Matrix<T>>& GetComputeWeights() const noexcept;
+  const std::vector<S21Matrix<T>>& GetComputeBiases() const noexcept;
+  // Copies weights_ and biases_ to the compute copies after every change.
+  void SyncComputeWeights();
   void InitWeights();
-  TestResults RunTests(std::vector<Emnist::Dataset>::iterator start,
-                       std::vector<Emnist::Dataset>::iterator end);
-  std::vector<double> Train(std::vector<Emnist::Dataset>& samples,
+  void SetLabels(std::vector<char> labels);
+  void LoadLabels(const std::string& mapping_path);
+  // Output neuron of the label of the sample at position.
+  size_t GetClass(const SampleStore& samples, size_t position) const;
+  void ResetInferenceModel();
+  Layers<T, Master>* CreateLayers() const;
+  Layers<T, Master>* GetWorkerLayers(size_t worker) const;
+  void ReduceDeltas();
+  std::vector<TestResults> RunIndependentFolds(const SampleStore& samples,
+                                               size_t k);
+  void TestSamples(Layers<T, Master>* worker, const SampleStore& samples,
+                   size_t begin, size_t end,
+                   S21Matrix<size_t>& confusion_matrix) const;
+  TestResults RunTests(const SampleStore& samples, size_t begin, size_t end);
+  std::vector<double> Train(const SampleStore& samples,
                             size_t iteration, size_t iterations_count);
+  void TrainSamples(Layers<T, Master>* worker, const SampleStore& samples,
+                    size_t begin, size_t end, std::vector<double>& losses);
+
+  static constexpr size_t kTestBatchSize = 256;
+  static constexpr size_t kStreamBlockSize = 8192;
+  static constexpr size_t kNoClass = SIZE_MAX;
 
   std::mt19937 random_gen_;
   NetworkImplementation network_implementation_;
-  Layers* layers;
-  std::vector<S21Matrix<double>> weights_;
-  std::vector<S21Matrix<double>> biases_;
-  size_t hidden_layers_count_;
+  Layers<T, Master>* layers;
+  std::vector<Layers<T, Master>*> worker_layers_;
+  ThreadPool thread_pool_;
+  std::vector<S21Matrix<Master>> weights_;
+  std::vector<S21Matrix<Master>> biases_;
+  // Used only when Master differs from T.
+  std::vector<S21Matrix<T>> compute_weights_;
+  std::vector<S21Matrix<T>> compute_biases_;
+  mutable std::mutex inference_model_mutex_;
+  mutable std::shared_ptr<const InferenceModel<T>> inference_model_;
+  std::vector<size_t> layer_sizes_;
+  std::vector<char> labels_;
+  // Output neuron of every label byte, kNoClass for other bytes.
+  std::array<size_t, 256> label_classes_;
+  NetworkFunctions functions_;
   bool trained = false;
+  bool batched_training_ = true;
+  bool static_inference_ = true;
 };
+
+using Network = BasicNetwork<double>;
 }  // namespace s21
 
 #endif  // CPP7_MLP_MODEL_NETWORK_H_
@@ -1,12 +1,47 @@
 #ifndef CPP7_MLP_MODEL_MATRIX_H_
 #define CPP7_MLP_MODEL_MATRIX_H_
 
+#include <algorithm>
 #include <cmath>
 #include <cstring>
-#include <functional>
 #include <iostream>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "kernels.h"
+#include "span.h"
 
 namespace s21 {
+template <class T>
+class S21Matrix;
+
+// Base of the lazy expression nodes built by the S21Matrix operators.
+template <class E>
+class MatrixExpression {
+ public:
+  const E& Self() const noexcept { return static_cast<const E&>(*this); }
+
+  // Writes the value of the expression into a buffer of its size. The
+  // buffer may be one of the operands, element i is read before written.
+  template <class T>
+  void AssignTo(T* out) const {
+    Self().Prepare();
+    size_t size = Self().GetRows() * Self().GetCols();
+    for (size_t i = 0; i < size; ++i) out[i] = Self().At(i);
+  }
+
+  // out[i] = Op::Apply(out[i], value[i]).
+  template <class Op, class T>
+  void Update(T* out) const {
+    Self().Prepare();
+    size_t size = Self().GetRows() * Self().GetCols();
+    for (size_t i = 0; i < size; ++i) out[i] = Op::Apply(out[i], Self().At(i));
+  }
+};
+
 template <class T>
 class S21Matrix {
  public:
@@ -15,6 +50,11 @@ class S21Matrix {
   explicit S21Matrix(size_t dimension);
   S21Matrix(const S21Matrix& other);
   S21Matrix(S21Matrix&& other) noexcept;
+  // Converts the elements of a matrix of another type.
+  template <class U>
+  explicit S21Matrix(const S21Matrix<U>& other);
+  template <class E>
+  S21Matrix(const MatrixExpression<E>& source);
   ~S21Matrix();
 
   bool EqMatrix(const S21Matrix& other) const;
@@ -22,66 +62,375 @@ class S21Matrix {
   void SubMatrix(const S21Matrix& other);
   void MulNumber(double num);
   void MulMatrix(const S21Matrix& other);
-  void UseFunction(std::function<T(T)> function);
+  void AddOuterProduct(const S21Matrix& left, const S21Matrix& right,
+                       T scale = T(1));
+  template <class F>
+  void UseFunction(F function);
   T Determinant() const;
   S21Matrix Transpose() const;
+  S21Matrix TransposedMul(const S21Matrix& other) const;
   S21Matrix CalcComplements() const;
   S21Matrix InverseMatrix() const;
 
-  S21Matrix operator+(const S21Matrix& other) const;
   S21Matrix operator+() const;
-  S21Matrix operator-(const S21Matrix& other) const;
-  S21Matrix operator-() const;
-  S21Matrix operator*(const S21Matrix& other) const;
-  S21Matrix operator*(double num) const;
-  template <class F>
-  friend S21Matrix<F> operator*(const double num, const S21Matrix<F>& other);
   S21Matrix& operator+=(const S21Matrix& other);
+  template <class E>
+  S21Matrix& operator+=(const MatrixExpression<E>& source);
   S21Matrix& operator-=(const S21Matrix& other);
+  template <class E>
+  S21Matrix& operator-=(const MatrixExpression<E>& source);
   S21Matrix& operator*=(const S21Matrix& other);
   S21Matrix& operator*=(double num);
   S21Matrix& operator=(const S21Matrix& other);
   S21Matrix& operator=(S21Matrix&& other) noexcept;
+  template <class E>
+  S21Matrix& operator=(const MatrixExpression<E>& source);
   bool operator==(const S21Matrix& other) const;
   T& operator()(size_t row, size_t col);
   T operator()(size_t row, size_t col) const;
 
+  // Fast paths for kernels: the row-major buffer, aligned to kAlignment
+  // bytes, row views and element access without the bounds check.
+  T* Data() noexcept;
+  const T* Data() const noexcept;
+  size_t GetSize() const noexcept;
+  Span<T> Row(size_t row);
+  Span<const T> Row(size_t row) const;
+  T& UncheckedAt(size_t row, size_t col);
+  T UncheckedAt(size_t row, size_t col) const;
+
+  static constexpr size_t kAlignment = 64;
+
   void SetRows(size_t rows);
   size_t GetRows() const noexcept;
   void SetCols(size_t cols);
   size_t GetCols() const noexcept;
 
  private:
+  static_assert(std::is_arithmetic_v<T>, "Matrix elements must be numbers");
+  static T* Allocate(size_t size);
+  static void Free(T* data) noexcept;
   T CalcMinor() const;
   size_t rows_;
   size_t cols_;
   T* matrix_;
 };
 
+// Lazy matrix arithmetic. Sums, differences, scaling and products build
+// small expression nodes instead of matrices; assigning a node (=, +=, -=
+// or construction) evaluates the whole tree in one pass over the
+// destination, so W -= rate * dW or W * x + b need no intermediate
+// matrices. Products run Gemm straight into the destination unless it is
+// one of the factors. Nodes refer to named operands, so an expression kept
+// in an `auto` variable must not outlive them.
+namespace expression {
+struct Plus {
+  template <class T>
+  static T Apply(T left, T right) {
+    return left + right;
+  }
+};
+
+struct Minus {
+  template <class T>
+  static T Apply(T left, T right) {
+    return left - right;
+  }
+};
+
+template <class E>
+struct ScalarOf {
+  using Type = typename E::Scalar;
+};
+
+template <class T>
+struct ScalarOf<S21Matrix<T>> {
+  using Type = T;
+};
+
+template <class X>
+using Scalar = typename ScalarOf<std::decay_t<X>>::Type;
+
+template <class X>
+struct IsMatrix : std::false_type {};
+
+template <class T>
+struct IsMatrix<S21Matrix<T>> : std::true_type {};
+
+template <class X>
+using IsExpression = std::bool_constant<
+    IsMatrix<std::decay_t<X>>::value ||
+    std::is_base_of_v<MatrixExpression<std::decay_t<X>>, std::decay_t<X>>>;
+
+// Leaf referring to a named matrix.
+template <class T>
+class Ref : public MatrixExpression<Ref<T>> {
+ public:
+  using Scalar = T;
+  explicit Ref(const S21Matrix<T>& matrix)
+      : data_(matrix.Data()),
+        rows_(matrix.GetRows()),
+        cols_(matrix.GetCols()) {}
+
+  size_t GetRows() const noexcept { return rows_; }
+  size_t GetCols() const noexcept { return cols_; }
+  T At(size_t index) const noexcept { return data_[index]; }
+  const T* Data() const noexcept { return data_; }
+  void Prepare() const noexcept {}
+  bool Aliases(const T* data) const noexcept { return data == data_; }
+
+ private:
+  const T* data_;
+  size_t rows_;
+  size_t cols_;
+};
+
+// Leaf owning a temporary matrix, so expressions over function results
+// stay valid after the full expression ends.
+template <class T>
+class Value : public MatrixExpression<Value<T>> {
+ public:
+  using Scalar = T;
+  explicit Value(S21Matrix<T>&& matrix) : matrix_(std::move(matrix)) {}
+
+  size_t GetRows() const noexcept { return matrix_.GetRows(); }
+  size_t GetCols() const noexcept { return matrix_.GetCols(); }
+  T At(size_t index) const noexcept { return Data()[index]; }
+  const T* Data() const noexcept { return matrix_.Data(); }
+  void Prepare() const noexcept {}
+  bool Aliases(const T*) const noexcept { return false; }
+
+ private:
+  S21Matrix<T> matrix_;
+};
+
+template <class L, class R>
+class Product;
+
+template <class E>
+struct IsProduct : std::false_type {};
+
+template <class L, class R>
+struct IsProduct<Product<L, R>> : std::true_type {};
+
+template <class L, class R, class Op>
+class Binary : public MatrixExpression<Binary<L, R, Op>> {
+ public:
+  using Scalar = typename L::Scalar;
+  Binary(L left, R right) : left_(std::move(left)), right_(std::move(right)) {
+    if (left_.GetRows() != right_.GetRows() ||
+        left_.GetCols() != right_.GetCols())
+      throw std::out_of_range("Matrices have different dimensions");
+  }
+
+  size_t GetRows() const noexcept { return left_.GetRows(); }
+  size_t GetCols() const noexcept { return left_.GetCols(); }
+  Scalar At(size_t index) const {
+    return Op::Apply(left_.At(index), right_.At(index));
+  }
+  void Prepare() const {
+    left_.Prepare();
+    right_.Prepare();
+  }
+  bool Aliases(const Scalar* data) const {
+    return left_.Aliases(data) || right_.Aliases(data);
+  }
+
+  // A * B + C starts from C and lets Gemm accumulate the product.
+  template <class T>
+  void AssignTo(T* out) const {
+    if constexpr (std::is_same_v<Op, Plus> && IsProduct<L>::value) {
+      if (!left_.Aliases(out)) {
+        right_.AssignTo(out);
+        left_.template Update<Plus>(out);
+        return;
+      }
+    }
+    MatrixExpression<Binary>::AssignTo(out);
+  }
+
+ private:
+  L left_;
+  R right_;
+};
+
+template <class E>
+class Scaled : public MatrixExpression<Scaled<E>> {
+ public:
+  using Scalar = typename E::Scalar;
+  Scaled(E operand, double scale)
+      : operand_(std::move(operand)), scale_(scale) {}
+
+  size_t GetRows() const noexcept { return operand_.GetRows(); }
+  size_t GetCols() const noexcept { return operand_.GetCols(); }
+  Scalar At(size_t index) const {
+    return static_cast<Scalar>(scale_ * operand_.At(index));
+  }
+  void Prepare() const { operand_.Prepare(); }
+  bool Aliases(const Scalar* data) const { return operand_.Aliases(data); }
+
+ private:
+  E operand_;
+  double scale_;
+};
+
+// Matrix product of two leaves. Inside a larger expression it is
+// evaluated once into its own buffer before the elementwise pass.
+template <class L, class R>
+class Product : public MatrixExpression<Product<L, R>> {
+ public:
+  using Scalar = typename L::Scalar;
+  Product(L left, R right) : left_(std::move(left)), right_(std::move(right)) {
+    if (left_.GetCols() != right_.GetRows())
+      throw std::out_of_range(
+          "Number of columns of ther first matrix is not equal to number of "
+          "rows of the second matrix");
+  }
+
+  size_t GetRows() const noexcept { return left_.GetRows(); }
+  size_t GetCols() const noexcept { return right_.GetCols(); }
+  Scalar At(size_t index) const noexcept { return result_[index]; }
+  void Prepare() const {
+    result_.resize(GetRows() * GetCols());
+    Multiply(Scalar(1), Scalar(), result_.data());
+  }
+  bool Aliases(const Scalar* data) const {
+    return left_.Aliases(data) || right_.Aliases(data);
+  }
+
+  template <class T>
+  void AssignTo(T* out) const {
+    if (Aliases(out))
+      MatrixExpression<Product>::AssignTo(out);
+    else
+      Multiply(Scalar(1), Scalar(), out);
+  }
+
+  template <class Op, class T>
+  void Update(T* out) const {
+    if (Aliases(out))
+      MatrixExpression<Product>::template Update<Op>(out);
+    else
+      Multiply(std::is_same_v<Op, Minus> ? Scalar(-1) : Scalar(1), Scalar(1),
+               out);
+  }
+
+ private:
+  void Multiply(Scalar alpha, Scalar beta, Scalar* out) const {
+    kernels::Gemm(false, false, GetRows(), GetCols(), left_.GetCols(), alpha,
+                  left_.Data(), left_.GetCols(), right_.Data(), GetCols(),
+                  beta, out, GetCols());
+  }
+
+  L left_;
+  R right_;
+  mutable std::vector<Scalar> result_;
+};
+
+template <class X>
+auto MakeOperand(X&& operand) {
+  using D = std::decay_t<X>;
+  if constexpr (!IsMatrix<D>::value)
+    return D(std::forward<X>(operand));
+  else if constexpr (std::is_lvalue_reference_v<X>)
+    return Ref<Scalar<D>>(operand);
+  else
+    return Value<Scalar<D>>(std::move(operand));
+}
+
+// Factors of a product must be stored matrices.
+template <class X>
+auto MakeLeaf(X&& operand) {
+  if constexpr (IsMatrix<std::decay_t<X>>::value)
+    return MakeOperand(std::forward<X>(operand));
+  else
+    return Value<Scalar<X>>(S21Matrix<Scalar<X>>(operand));
+}
+
+template <class Op, class L, class R>
+Binary<L, R, Op> MakeBinary(L left, R right) {
+  return Binary<L, R, Op>(std::move(left), std::move(right));
+}
+
+template <class L, class R>
+Product<L, R> MakeProduct(L left, R right) {
+  return Product<L, R>(std::move(left), std::move(right));
+}
+
+template <class E>
+Scaled<E> MakeScaled(E operand, double scale) {
+  return Scaled<E>(std::move(operand), scale);
+}
+
+template <class L, class R>
+using EnableIfExpressions = std::enable_if_t<IsExpression<L>::value &&
+                                             IsExpression<R>::value>;
+
+template <class E>
+using EnableIfExpression = std::enable_if_t<IsExpression<E>::value>;
+}  // namespace expression
+
+template <class L, class R, class = expression::EnableIfExpressions<L, R>>
+auto operator+(L&& left, R&& right) {
+  return expression::MakeBinary<expression::Plus>(
+      expression::MakeOperand(std::forward<L>(left)),
+      expression::MakeOperand(std::forward<R>(right)));
+}
+
+template <class L, class R, class = expression::EnableIfExpressions<L, R>>
+auto operator-(L&& left, R&& right) {
+  return expression::MakeBinary<expression::Minus>(
+      expression::MakeOperand(std::forward<L>(left)),
+      expression::MakeOperand(std::forward<R>(right)));
+}
+
+template <class E, class = expression::EnableIfExpression<E>>
+auto operator-(E&& operand) {
+  return expression::MakeScaled(
+      expression::MakeOperand(std::forward<E>(operand)), -1.0);
+}
+
+template <class L, class R, class = expression::EnableIfExpressions<L, R>>
+auto operator*(L&& left, R&& right) {
+  return expression::MakeProduct(expression::MakeLeaf(std::forward<L>(left)),
+                                 expression::MakeLeaf(std::forward<R>(right)));
+}
+
+template <class E, class = expression::EnableIfExpression<E>>
+auto operator*(E&& operand, double num) {
+  return expression::MakeScaled(
+      expression::MakeOperand(std::forward<E>(operand)), num);
+}
+
+template <class E, class = expression::EnableIfExpression<E>>
+auto operator*(double num, E&& operand) {
+  return expression::MakeScaled(
+      expression::MakeOperand(std::forward<E>(operand)), num);
+}
+
 template <class T>
 S21Matrix<T>::S21Matrix() : rows_(3), cols_(3) {
-  matrix_ = new T[rows_ * cols_]();
+  matrix_ = Allocate(rows_ * cols_);
 }
 
 template <class T>
 S21Matrix<T>::S21Matrix(size_t rows, size_t cols) : rows_(rows), cols_(cols) {
   if (rows == 0 || cols == 0)
     throw std::out_of_range("Number of rows or columns is equel to zero");
-  matrix_ = new T[rows_ * cols_]();
+  matrix_ = Allocate(rows_ * cols_);
 }
 
 template <class T>
 S21Matrix<T>::S21Matrix(size_t dimension) : rows_(dimension), cols_(dimension) {
   if (rows_ == 0) throw std::out_of_range("Dimension is equel to zero");
-  matrix_ = new T[rows_ * cols_]();
+  matrix_ = Allocate(rows_ * cols_);
 }
 
 template <class T>
 S21Matrix<T>::S21Matrix(const S21Matrix& other)
     : rows_(other.rows_), cols_(other.cols_) {
-  matrix_ = new T[rows_ * cols_]();
-  for (size_t row = 0; row < rows_ * cols_; ++row)
-    matrix_[row] = other.matrix_[row];
+  matrix_ = Allocate(rows_ * cols_);
+  std::copy(other.matrix_, other.matrix_ + rows_ * cols_, matrix_);
 }
 
 template <class T>
@@ -93,9 +442,30 @@ S21Matrix<T>::S21Matrix(S21Matrix&& other) noexcept
   other.cols_ = 0;
 }
 
+template <class T>
+template <class U>
+S21Matrix<T>::S21Matrix(const S21Matrix<U>& other)
+    : rows_(other.GetRows()), cols_(other.GetCols()) {
+  matrix_ = Allocate(rows_ * cols_);
+  std::copy(other.Data(), other.Data() + rows_ * cols_, matrix_);
+}
+
+template <class T>
+template <class E>
+S21Matrix<T>::S21Matrix(const MatrixExpression<E>& source)
+    : rows_(source.Self().GetRows()), cols_(source.Self().GetCols()) {
+  matrix_ = Allocate(rows_ * cols_);
+  try {
+    source.Self().AssignTo(matrix_);
+  } catch (...) {
+    Free(matrix_);
+    throw;
+  }
+}
+
 template <class T>
 S21Matrix<T>::~S21Matrix() {
-  delete[] matrix_;
+  Free(matrix_);
 }
 
 template <class T>
@@ -109,45 +479,43 @@ bool S21Matrix<T>::EqMatrix(const S21Matrix& other) const {
 
 template <class T>
 void S21Matrix<T>::SumMatrix(const S21Matrix& other) {
-  if (rows_ != other.rows_ || cols_ != other.cols_)
-    throw std::out_of_range("Matrices have different dimensions");
-  for (size_t row = 0; row < rows_; ++row)
-    for (size_t col = 0; col < cols_; ++col)
-      (*this)(row, col) += other(row, col);
+  *this += expression::Ref<T>(other);
 }
 
 template <class T>
 void S21Matrix<T>::SubMatrix(const S21Matrix& other) {
-  SumMatrix(-other);
+  *this -= expression::Ref<T>(other);
 }
 
 template <class T>
 void S21Matrix<T>::MulNumber(double num) {
-  for (size_t row = 0; row < rows_; ++row)
-    for (size_t col = 0; col < cols_; ++col) (*this)(row, col) *= num;
+  for (size_t i = 0; i < rows_ * cols_; ++i) matrix_[i] *= num;
 }
 
 template <class T>
 void S21Matrix<T>::MulMatrix(const S21Matrix& other) {
-  if (cols_ != other.rows_)
-    throw std::out_of_range(
-        "Number of columns of ther first matrix is not equal to number of rows "
-        "of the second matrix");
-  S21Matrix<T> result(rows_, other.cols_);
-  for (size_t row = 0; row < rows_; ++row)
-    for (size_t col = 0; col < other.cols_; ++col) {
-      T sum = T();
-      for (size_t x = 0; x < cols_; ++x) sum += (*this)(row, x) * other(x, col);
-      result(row, col) = sum;
-    }
-  *this = std::move(result);
+  *this = *this * other;
 }
 
 template <class T>
-void S21Matrix<T>::UseFunction(std::function<T(T)> function) {
-  for (size_t row = 0; row < rows_; ++row)
-    for (size_t col = 0; col < cols_; ++col)
-      (*this)(row, col) = function((*this)(row, col));
+void S21Matrix<T>::AddOuterProduct(const S21Matrix& left,
+                                   const S21Matrix& right, T scale) {
+  if (left.cols_ != right.cols_ || left.rows_ != rows_ ||
+      right.rows_ != cols_)
+    throw std::out_of_range("Operands do not match dimensions of the matrix");
+  if (left.cols_ == 1)
+    kernels::Ger(rows_, cols_, scale, left.matrix_, right.matrix_, matrix_,
+                 cols_);
+  else
+    kernels::Gemm(false, true, rows_, cols_, left.cols_, scale, left.matrix_,
+                  left.cols_, right.matrix_, right.cols_, T(1), matrix_,
+                  cols_);
+}
+
+template <class T>
+template <class F>
+void S21Matrix<T>::UseFunction(F function) {
+  kernels::Map(rows_ * cols_, matrix_, function);
 }
 
 template <class T>
@@ -159,6 +527,18 @@ S21Matrix<T> S21Matrix<T>::Transpose() const {
   return result;
 }
 
+template <class T>
+S21Matrix<T> S21Matrix<T>::TransposedMul(const S21Matrix& other) const {
+  if (rows_ != other.rows_)
+    throw std::out_of_range(
+        "Number of rows of the first matrix is not equal to number of rows of "
+        "the second matrix");
+  S21Matrix<T> result(cols_, other.cols_);
+  kernels::Gemm(true, false, cols_, other.cols_, rows_, T(1), matrix_, cols_,
+                other.matrix_, other.cols_, T(), result.matrix_, other.cols_);
+  return result;
+}
+
 template <class T>
 S21Matrix<T> S21Matrix<T>::CalcComplements() const {
   if (rows_ != cols_) throw std::out_of_range("Matrix is not quadratic");
@@ -232,61 +612,38 @@ T S21Matrix<T>::CalcMinor() const {
   return result;
 }
 
-template <class T>
-S21Matrix<T> S21Matrix<T>::operator+(const S21Matrix& other) const {
-  S21Matrix<T> result(*this);
-  result.SumMatrix(other);
-  return result;
-}
-
 template <class T>
 S21Matrix<T> S21Matrix<T>::operator+() const {
   return *this;
 }
 
 template <class T>
-S21Matrix<T> S21Matrix<T>::operator-(const S21Matrix& other) const {
-  S21Matrix<T> result(*this);
-  result.SubMatrix(other);
-  return result;
-}
-
-template <class T>
-S21Matrix<T> S21Matrix<T>::operator-() const {
-  S21Matrix<T> result = *this * -1;
-  return result;
-}
-
-template <class T>
-S21Matrix<T> S21Matrix<T>::operator*(const S21Matrix& other) const {
-  S21Matrix<T> result(*this);
-  result.MulMatrix(other);
-  return result;
-}
-
-template <class T>
-S21Matrix<T> S21Matrix<T>::operator*(double num) const {
-  S21Matrix<T> result(*this);
-  result.MulNumber(num);
-  return result;
+S21Matrix<T>& S21Matrix<T>::operator+=(const S21Matrix& other) {
+  SumMatrix(other);
+  return *this;
 }
 
 template <class T>
-S21Matrix<T> operator*(double num, const S21Matrix<T>& other) {
-  S21Matrix<T> result(other);
-  result.MulNumber(num);
-  return result;
+template <class E>
+S21Matrix<T>& S21Matrix<T>::operator+=(const MatrixExpression<E>& source) {
+  if (rows_ != source.Self().GetRows() || cols_ != source.Self().GetCols())
+    throw std::out_of_range("Matrices have different dimensions");
+  source.Self().template Update<expression::Plus>(matrix_);
+  return *this;
 }
 
 template <class T>
-S21Matrix<T>& S21Matrix<T>::operator+=(const S21Matrix& other) {
-  SumMatrix(other);
+S21Matrix<T>& S21Matrix<T>::operator-=(const S21Matrix& other) {
+  SubMatrix(other);
   return *this;
 }
 
 template <class T>
-S21Matrix<T>& S21Matrix<T>::operator-=(const S21Matrix& other) {
-  SubMatrix(other);
+template <class E>
+S21Matrix<T>& S21Matrix<T>::operator-=(const MatrixExpression<E>& source) {
+  if (rows_ != source.Self().GetRows() || cols_ != source.Self().GetCols())
+    throw std::out_of_range("Matrices have different dimensions");
+  source.Self().template Update<expression::Minus>(matrix_);
   return *this;
 }
 
@@ -305,10 +662,13 @@ S21Matrix<T>& S21Matrix<T>::operator*=(const double num) {
 template <class T>
 S21Matrix<T>& S21Matrix<T>::operator=(const S21Matrix& other) {
   if (&other == this) return *this;
-  delete[] matrix_;
-  matrix_ = new T[other.rows_ * other.cols_];
-  for (size_t row = 0; row < other.rows_ * other.cols_; ++row)
-    matrix_[row] = other.matrix_[row];
+  if (rows_ * cols_ != other.rows_ * other.cols_) {
+    T* data = Allocate(other.rows_ * other.cols_);
+    Free(matrix_);
+    matrix_ = data;
+  }
+  std::copy(other.matrix_, other.matrix_ + other.rows_ * other.cols_,
+            matrix_);
   rows_ = other.rows_;
   cols_ = other.cols_;
   return *this;
@@ -322,6 +682,17 @@ S21Matrix<T>& S21Matrix<T>::operator=(S21Matrix&& other) noexcept {
   return *this;
 }
 
+// Evaluates in place when the shape is unchanged; otherwise into a fresh
+// buffer, since operands may still refer to the old one.
+template <class T>
+template <class E>
+S21Matrix<T>& S21Matrix<T>::operator=(const MatrixExpression<E>& source) {
+  if (rows_ != source.Self().GetRows() || cols_ != source.Self().GetCols())
+    return *this = S21Matrix(source);
+  source.Self().AssignTo(matrix_);
+  return *this;
+}
+
 template <class T>
 bool S21Matrix<T>::operator==(const S21Matrix& other) const {
   return EqMatrix(other);
@@ -340,15 +711,74 @@ T S21Matrix<T>::operator()(size_t row, size_t col) const {
   return matrix_[cols_ * row + col];
 }
 
+template <class T>
+T* S21Matrix<T>::Data() noexcept {
+  return matrix_;
+}
+
+template <class T>
+const T* S21Matrix<T>::Data() const noexcept {
+  return matrix_;
+}
+
+template <class T>
+size_t S21Matrix<T>::GetSize() const noexcept {
+  return rows_ * cols_;
+}
+
+template <class T>
+Span<T> S21Matrix<T>::Row(size_t row) {
+  if constexpr (kBoundsCheck)
+    if (row >= rows_) throw std::out_of_range("Index is outside the matrix");
+  return Span<T>(matrix_ + cols_ * row, cols_);
+}
+
+template <class T>
+Span<const T> S21Matrix<T>::Row(size_t row) const {
+  if constexpr (kBoundsCheck)
+    if (row >= rows_) throw std::out_of_range("Index is outside the matrix");
+  return Span<const T>(matrix_ + cols_ * row, cols_);
+}
+
+template <class T>
+T& S21Matrix<T>::UncheckedAt(size_t row, size_t col) {
+  if constexpr (kBoundsCheck)
+    if (row >= rows_ || col >= cols_)
+      throw std::out_of_range("Index is outside the matrix");
+  return matrix_[cols_ * row + col];
+}
+
+template <class T>
+T S21Matrix<T>::UncheckedAt(size_t row, size_t col) const {
+  if constexpr (kBoundsCheck)
+    if (row >= rows_ || col >= cols_)
+      throw std::out_of_range("Index is outside the matrix");
+  return matrix_[cols_ * row + col];
+}
+
+// Zero-initialized storage aligned for full-width vector loads.
+template <class T>
+T* S21Matrix<T>::Allocate(size_t size) {
+  auto data = static_cast<T*>(::operator new[](
+      size * sizeof(T), std::align_val_t(kAlignment)));
+  std::fill(data, data + size, T());
+  return data;
+}
+
+template <class T>
+void S21Matrix<T>::Free(T* data) noexcept {
+  ::operator delete[](data, std::align_val_t(kAlignment));
+}
+
 template <class T>
 void S21Matrix<T>::SetRows(size_t rows) {
   if (rows == 0) throw std::out_of_range("Index is equel to zero");
   if (rows_ == rows) return;
-  T* temp = new T[rows * cols_]();
+  T* temp = Allocate(rows * cols_);
   for (size_t row = 0; row < rows; ++row)
     for (size_t col = 0; col < cols_; ++col)
       temp[row * cols_ + col] = row < rows_ ? matrix_[row * cols_ + col] : T();
-  delete[] matrix_;
+  Free(matrix_);
   matrix_ = temp;
   rows_ = rows;
 }
@@ -362,11 +792,11 @@ template <class T>
 void S21Matrix<T>::SetCols(size_t cols) {
   if (cols == 0) throw std::out_of_range("Index is equel to zero");
   if (cols_ == cols) return;
-  T* temp = new T[rows_ * cols]();
+  T* temp = Allocate(rows_ * cols);
   for (size_t row = 0; row < rows_; ++row)
     for (size_t col = 0; col < cols; ++col)
       temp[row * cols + col] = col < cols_ ? matrix_[row * cols_ + col] : T();
-  delete[] matrix_;
+  Free(matrix_);
   matrix_ = temp;
   cols_ = cols;
 }
@@ -0,0 +1,130 @@
+#include "sample_store.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace s21 {
+SampleStore::SampleStore()
+    : labels_(std::make_shared<const std::vector<char>>()) {}
+
+SampleStore::SampleStore(PixelBuffer pixels, std::vector<char> labels,
+                         size_t image_size) {
+  if (pixels.size() != labels.size() * image_size)
+    throw std::runtime_error("Number of pixels does not match labels");
+  auto buffer = std::make_shared<const PixelBuffer>(std::move(pixels));
+  pixels_ = buffer->data();
+  owner_ = std::move(buffer);
+  labels_ = std::make_shared<const std::vector<char>>(std::move(labels));
+  image_size_ = image_size;
+  size_ = labels_->size();
+  order_ = std::make_shared<std::vector<uint32_t>>(size_);
+  std::iota(order_->begin(), order_->end(), 0);
+}
+
+SampleStore::SampleStore(std::shared_ptr<const void> owner,
+                         const uint8_t* pixels, std::vector<char> labels,
+                         size_t image_size)
+    : owner_(std::move(owner)),
+      pixels_(pixels),
+      labels_(std::make_shared<const std::vector<char>>(std::move(labels))),
+      image_size_(image_size),
+      order_(std::make_shared<std::vector<uint32_t>>(labels_->size())),
+      size_(labels_->size()) {
+  std::iota(order_->begin(), order_->end(), 0);
+}
+
+size_t SampleStore::GetSize() const noexcept { return size_; }
+
+size_t SampleStore::GetImageSize() const noexcept { return image_size_; }
+
+const uint8_t* SampleStore::GetPixels(size_t position) const noexcept {
+  return pixels_ + GetIndex(position) * image_size_;
+}
+
+char SampleStore::GetLowerCaseLetter(size_t position) const noexcept {
+  return (*labels_)[GetIndex(position)];
+}
+
+template <class T>
+void SampleStore::GetImage(size_t position, S21Matrix<T>& image) const {
+  if (image.GetSize() != image_size_)
+    throw std::out_of_range("Image does not match the dataset");
+  const uint8_t* pixels = GetPixels(position);
+  T* data = image.Data();
+  for (size_t row = 0; row < image_size_; ++row)
+    data[row] = pixels[row] / T(255);
+}
+
+template <class T>
+void SampleStore::Gather(size_t begin, size_t count,
+                         S21Matrix<T>& images) const {
+  if (images.GetRows() != image_size_ || images.GetCols() < count)
+    throw std::out_of_range("Images do not match the dataset");
+  size_t stride = images.GetCols();
+  for (size_t col = 0; col < count; ++col) {
+    const uint8_t* pixels = GetPixels(begin + col);
+    T* data = images.Data() + col;
+    for (size_t row = 0; row < image_size_; ++row)
+      data[row * stride] = pixels[row] / T(255);
+  }
+}
+
+template void SampleStore::GetImage(size_t, S21Matrix<float>&) const;
+template void SampleStore::GetImage(size_t, S21Matrix<double>&) const;
+template void SampleStore::Gather(size_t, size_t, S21Matrix<float>&) const;
+template void SampleStore::Gather(size_t, size_t, S21Matrix<double>&) const;
+
+void SampleStore::Shuffle(std::mt19937& random_gen) {
+  Detach();
+  std::shuffle(order_->begin(), order_->end(), random_gen);
+}
+
+SampleStore SampleStore::Select(size_t begin, size_t end) const {
+  if (begin > end || end > size_)
+    throw std::out_of_range("Range is outside the sample store");
+  SampleStore result(*this);
+  if (hole_size_ != 0 && begin < hole_begin_ && end > hole_begin_) {
+    result.Detach();
+    return result.Select(begin, end);
+  }
+  result.begin_ += begin;
+  if (begin >= hole_begin_) result.begin_ += hole_size_;
+  result.hole_begin_ = 0;
+  result.hole_size_ = 0;
+  result.size_ = end - begin;
+  return result;
+}
+
+SampleStore SampleStore::Exclude(size_t begin, size_t end) const {
+  if (begin > end || end > size_)
+    throw std::out_of_range("Range is outside the sample store");
+  SampleStore result(*this);
+  if (hole_size_ != 0) {
+    result.Detach();
+    return result.Exclude(begin, end);
+  }
+  result.hole_begin_ = begin;
+  result.hole_size_ = end - begin;
+  result.size_ -= end - begin;
+  return result;
+}
+
+size_t SampleStore::GetIndex(size_t position) const noexcept {
+  if (position >= hole_begin_) position += hole_size_;
+  return (*order_)[begin_ + position];
+}
+
+void SampleStore::Detach() {
+  if (order_.use_count() == 1 && begin_ == 0 && hole_size_ == 0 &&
+      size_ == order_->size())
+    return;
+  auto order = std::make_shared<std::vector<uint32_t>>();
+  order->reserve(size_);
+  for (size_t position = 0; position < size_; ++position)
+    order->push_back(GetIndex(position));
+  order_ = std::move(order);
+  begin_ = 0;
+  hole_begin_ = 0;
+  hole_size_ = 0;
+}
+}  // namespace s21
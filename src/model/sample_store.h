@@ -0,0 +1,91 @@
+#ifndef CPP7_MLP_MODEL_SAMPLE_STORE_H_
+#define CPP7_MLP_MODEL_SAMPLE_STORE_H_
+
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+#include "s21_matrix.h"
+
+namespace s21 {
+template <class T, size_t Alignment>
+class AlignedAllocator {
+ public:
+  using value_type = T;
+  template <class U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+  template <class U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+  T* allocate(size_t count) {
+    return static_cast<T*>(
+        ::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+  }
+  void deallocate(T* ptr, size_t) noexcept {
+    ::operator delete(ptr, std::align_val_t(Alignment));
+  }
+
+  template <class U>
+  bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept {
+    return true;
+  }
+  template <class U>
+  bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept {
+    return false;
+  }
+};
+
+// Structure-of-arrays storage of labelled images. All pixels live in one
+// contiguous uint8 block and are normalized to [0, 1] when they are read.
+// Samples are addressed through a permutation of positions, so shuffling
+// never moves pixel data. Copies share the storage and the permutation:
+// Select and Exclude return O(1) views of a range of positions or of
+// everything outside it, which is how cross-validation folds are built.
+class SampleStore {
+ public:
+  // Pixel rows are gathered into S21Matrix buffers with the same alignment.
+  static constexpr size_t kAlignment = S21Matrix<uint8_t>::kAlignment;
+  using PixelBuffer =
+      std::vector<uint8_t, AlignedAllocator<uint8_t, kAlignment>>;
+
+  SampleStore();
+  SampleStore(PixelBuffer pixels, std::vector<char> labels, size_t image_size);
+  SampleStore(std::shared_ptr<const void> owner, const uint8_t* pixels,
+              std::vector<char> labels, size_t image_size);
+
+  size_t GetSize() const noexcept;
+  size_t GetImageSize() const noexcept;
+  const uint8_t* GetPixels(size_t position) const noexcept;
+  char GetLowerCaseLetter(size_t position) const noexcept;
+  // Images are float or double.
+  template <class T>
+  void GetImage(size_t position, S21Matrix<T>& image) const;
+  template <class T>
+  void Gather(size_t begin, size_t count, S21Matrix<T>& images) const;
+  void Shuffle(std::mt19937& random_gen);
+  SampleStore Select(size_t begin, size_t end) const;
+  SampleStore Exclude(size_t begin, size_t end) const;
+
+ private:
+  size_t GetIndex(size_t position) const noexcept;
+  void Detach();
+
+  std::shared_ptr<const void> owner_;
+  const uint8_t* pixels_ = nullptr;
+  std::shared_ptr<const std::vector<char>> labels_;
+  size_t image_size_ = 0;
+  std::shared_ptr<std::vector<uint32_t>> order_;
+  size_t begin_ = 0;
+  size_t size_ = 0;
+  size_t hole_begin_ = 0;
+  size_t hole_size_ = 0;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_SAMPLE_STORE_H_
@@ -0,0 +1,40 @@
+#ifndef CPP7_MLP_MODEL_SPAN_H_
+#define CPP7_MLP_MODEL_SPAN_H_
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace s21 {
+// Unchecked accessors of S21Matrix and Span validate their indices only in
+// builds with S21_BOUNDS_CHECK defined (make debug); operator() of
+// S21Matrix always does.
+#ifdef S21_BOUNDS_CHECK
+inline constexpr bool kBoundsCheck = true;
+#else
+inline constexpr bool kBoundsCheck = false;
+#endif
+
+// Non-owning view of a contiguous range, e.g. a matrix row.
+template <class T>
+class Span {
+ public:
+  Span() noexcept = default;
+  Span(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+  T& operator[](size_t index) const {
+    if constexpr (kBoundsCheck)
+      if (index >= size_) throw std::out_of_range("Index is outside the span");
+    return data_[index];
+  }
+  T* Data() const noexcept { return data_; }
+  size_t GetSize() const noexcept { return size_; }
+  T* begin() const noexcept { return data_; }
+  T* end() const noexcept { return data_ + size_; }
+
+ private:
+  T* data_ = nullptr;
+  size_t size_ = 0;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_SPAN_H_
@@ -0,0 +1,38 @@
+#include "static_network.h"
+
+namespace s21 {
+namespace {
+// Default topologies: EMNIST images, two to five hidden layers of 50 neurons
+// and 26 letters.
+template <class T, size_t... Sizes>
+using DefaultNetwork = StaticNetwork<T, 784, Sizes..., 26>;
+
+template <class T, class... Networks>
+std::unique_ptr<StaticEngine<T>> CreateMatching(
+    const std::vector<S21Matrix<T>>& weights,
+    const std::vector<S21Matrix<T>>& biases,
+    const NetworkFunctions& functions) {
+  std::unique_ptr<StaticEngine<T>> engine;
+  static_cast<void>(
+      ((Networks::Matches(weights) &&
+        (engine = std::make_unique<Networks>(weights, biases, functions))) ||
+       ...));
+  return engine;
+}
+}  // namespace
+
+template <class T>
+std::unique_ptr<StaticEngine<T>> StaticEngine<T>::Create(
+    const std::vector<S21Matrix<T>>& weights,
+    const std::vector<S21Matrix<T>>& biases,
+    const NetworkFunctions& functions) {
+  return CreateMatching<T, DefaultNetwork<T, 50, 50>,
+                        DefaultNetwork<T, 50, 50, 50>,
+                        DefaultNetwork<T, 50, 50, 50, 50>,
+                        DefaultNetwork<T, 50, 50, 50, 50, 50>>(
+      weights, biases, functions);
+}
+
+template class StaticEngine<float>;
+template class StaticEngine<double>;
+}  // namespace s21
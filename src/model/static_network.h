@@ -0,0 +1,159 @@
+#ifndef CPP7_MLP_MODEL_STATIC_NETWORK_H_
+#define CPP7_MLP_MODEL_STATIC_NETWORK_H_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "activation.h"
+#include "kernels.h"
+#include "s21_matrix.h"
+
+namespace s21 {
+// Single-image forward pass in T, float or double, of a network whose
+// topology is known at compile time. Create returns a precompiled
+// StaticNetwork matching the weights, or nullptr when there is none.
+template <class T>
+class StaticEngine {
+ public:
+  virtual ~StaticEngine() = default;
+
+  // Writes the output activations of one image. Safe to call from any
+  // number of threads.
+  virtual void FeedForward(const T* image, T* outputs) const = 0;
+
+  static std::unique_ptr<StaticEngine> Create(
+      const std::vector<S21Matrix<T>>& weights,
+      const std::vector<S21Matrix<T>>& biases,
+      const NetworkFunctions& functions);
+};
+
+// Sizes are the neuron counts of every layer, the input layer first. Each
+// layer keeps its weights transposed and padded to whole SIMD registers, so
+// a layer is one pass over its inputs accumulating all outputs in registers.
+// Activations live in stack buffers.
+template <class T, size_t... Sizes>
+class StaticNetwork final : public StaticEngine<T> {
+ public:
+  static constexpr std::array<size_t, sizeof...(Sizes)> kLayerSizes = {
+      Sizes...};
+  static constexpr size_t kLayersCount = sizeof...(Sizes) - 1;
+
+  static_assert(kLayersCount >= 1, "A network needs at least two layers");
+
+  StaticNetwork(const std::vector<S21Matrix<T>>& weights,
+                const std::vector<S21Matrix<T>>& biases,
+                const NetworkFunctions& functions);
+
+  static bool Matches(const std::vector<S21Matrix<T>>& weights);
+
+  void FeedForward(const T* image, T* outputs) const override;
+
+ private:
+  using V = kernels::Vec<T>;
+
+  static constexpr size_t Padded(size_t size) {
+    return (size + V::kWidth - 1) / V::kWidth * V::kWidth;
+  }
+
+  static constexpr size_t GetBufferSize() {
+    size_t size = 0;
+    for (size_t layer = 1; layer <= kLayersCount; ++layer)
+      size = std::max(size, Padded(kLayerSizes[layer]));
+    return size;
+  }
+
+  // output = W * input without the biases, one register per block of
+  // outputs. The blocks are unrolled so the sums stay in registers.
+  template <size_t Inputs, size_t... Blocks>
+  static void Multiply(const T* weights, const T* input, T* output,
+                       std::index_sequence<Blocks...>);
+
+  template <size_t Layer>
+  void Forward(const T* input, T* buffer, T* spare) const;
+
+  std::array<S21Matrix<T>, kLayersCount> weights_;
+  std::array<S21Matrix<T>, kLayersCount> biases_;
+  const NetworkFunctions functions_;
+};
+
+template <class T, size_t... Sizes>
+StaticNetwork<T, Sizes...>::StaticNetwork(
+    const std::vector<S21Matrix<T>>& weights,
+    const std::vector<S21Matrix<T>>& biases,
+    const NetworkFunctions& functions)
+    : functions_(functions) {
+  if (!Matches(weights) || biases.size() != kLayersCount)
+    throw std::runtime_error("Weights do not match the network");
+  for (size_t layer = 0; layer < kLayersCount; ++layer) {
+    size_t rows = kLayerSizes[layer + 1];
+    size_t cols = kLayerSizes[layer];
+    weights_[layer] = S21Matrix<T>(cols, Padded(rows));
+    for (size_t row = 0; row < rows; ++row)
+      for (size_t col = 0; col < cols; ++col)
+        weights_[layer].UncheckedAt(col, row) =
+            weights[layer].UncheckedAt(row, col);
+    if (biases[layer].GetRows() != rows)
+      throw std::runtime_error("Weights do not match biases");
+    biases_[layer] = biases[layer];
+  }
+}
+
+template <class T, size_t... Sizes>
+bool StaticNetwork<T, Sizes...>::Matches(
+    const std::vector<S21Matrix<T>>& weights) {
+  if (weights.size() != kLayersCount) return false;
+  for (size_t layer = 0; layer < kLayersCount; ++layer)
+    if (weights[layer].GetRows() != kLayerSizes[layer + 1] ||
+        weights[layer].GetCols() != kLayerSizes[layer])
+      return false;
+  return true;
+}
+
+template <class T, size_t... Sizes>
+void StaticNetwork<T, Sizes...>::FeedForward(const T* image,
+                                             T* outputs) const {
+  alignas(64) T buffer[GetBufferSize()];
+  alignas(64) T spare[GetBufferSize()];
+  Forward<0>(image, buffer, spare);
+  std::copy_n(kLayersCount % 2 ? buffer : spare, kLayerSizes.back(), outputs);
+}
+
+template <class T, size_t... Sizes>
+template <size_t Inputs, size_t... Blocks>
+void StaticNetwork<T, Sizes...>::Multiply(const T* weights, const T* input,
+                                          T* output,
+                                          std::index_sequence<Blocks...>) {
+  constexpr size_t kStride = sizeof...(Blocks) * V::kWidth;
+  typename V::Type sums[] = {(static_cast<void>(Blocks), V::Zero())...};
+  for (size_t col = 0; col < Inputs; ++col) {
+    auto value = V::Set1(input[col]);
+    const T* column = weights + col * kStride;
+    ((sums[Blocks] = V::FMAdd(V::Load(column + Blocks * V::kWidth), value,
+                              sums[Blocks])),
+     ...);
+  }
+  (V::Store(output + Blocks * V::kWidth, sums[Blocks]), ...);
+}
+
+template <class T, size_t... Sizes>
+template <size_t Layer>
+void StaticNetwork<T, Sizes...>::Forward(const T* input, T* buffer,
+                                         T* spare) const {
+  constexpr size_t kOutputs = kLayerSizes[Layer + 1];
+  Multiply<kLayerSizes[Layer]>(
+      weights_[Layer].Data(), input, buffer,
+      std::make_index_sequence<Padded(kOutputs) / V::kWidth>());
+  if constexpr (Layer + 1 < kLayersCount) {
+    functions_.ActivateHidden(kOutputs, 1, biases_[Layer].Data(), buffer);
+    Forward<Layer + 1>(buffer, spare, buffer);
+  } else {
+    functions_.ActivateOutput(kOutputs, 1, biases_[Layer].Data(), buffer);
+  }
+}
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_STATIC_NETWORK_H_
@@ -0,0 +1,88 @@
+#include "thread_pool.h"
+
+namespace s21 {
+ThreadPool::ThreadPool(size_t threads_count) { Start(threads_count); }
+
+ThreadPool::~ThreadPool() { Stop(); }
+
+void ThreadPool::Run(size_t tasks_count,
+                     const std::function<void(size_t)>& task) {
+  if (workers_.empty() || tasks_count <= 1) {
+    for (size_t i = 0; i < tasks_count; ++i) task(i);
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    task_ = &task;
+    tasks_count_ = tasks_count;
+    next_task_ = 0;
+    active_workers_ = workers_.size();
+    error_ = nullptr;
+    ++generation_;
+  }
+  start_condition_.notify_all();
+  ExecuteTasks();
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  done_condition_.wait(lock, [this] { return active_workers_ == 0; });
+  task_ = nullptr;
+  if (error_) std::rethrow_exception(error_);
+}
+
+void ThreadPool::SetThreadsCount(size_t threads_count) {
+  if (threads_count == 0) throw std::runtime_error("Invalid number of threads");
+  if (threads_count == GetThreadsCount()) return;
+  Stop();
+  Start(threads_count);
+}
+
+size_t ThreadPool::GetThreadsCount() const noexcept {
+  return workers_.size() + 1;
+}
+
+void ThreadPool::Start(size_t threads_count) {
+  stop_ = false;
+  workers_.reserve(threads_count > 0 ? threads_count - 1 : 0);
+  for (size_t i = 1; i < threads_count; ++i)
+    workers_.emplace_back(&ThreadPool::WorkerLoop, this, generation_);
+}
+
+void ThreadPool::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  start_condition_.notify_all();
+  for (auto& worker : workers_) worker.join();
+  workers_.clear();
+}
+
+void ThreadPool::WorkerLoop(size_t generation) {
+  size_t seen_generation = generation;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      start_condition_.wait(lock, [this, seen_generation] {
+        return stop_ || generation_ != seen_generation;
+      });
+      if (stop_) return;
+      seen_generation = generation_;
+    }
+    ExecuteTasks();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (--active_workers_ == 0) done_condition_.notify_one();
+  }
+}
+
+void ThreadPool::ExecuteTasks() {
+  size_t index;
+  while ((index = next_task_++) < tasks_count_) {
+    try {
+      (*task_)(index);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+    }
+  }
+}
+}  // namespace s21
@@ -0,0 +1,50 @@
+#ifndef CPP7_MLP_MODEL_THREAD_POOL_H_
+#define CPP7_MLP_MODEL_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace s21 {
+class ThreadPool {
+ public:
+  explicit ThreadPool(size_t threads_count = 1);
+  ThreadPool(const ThreadPool& pool) = delete;
+  ThreadPool(ThreadPool&& pool) = delete;
+  ThreadPool& operator=(const ThreadPool& pool) = delete;
+  ThreadPool& operator=(ThreadPool&& pool) = delete;
+  ~ThreadPool();
+
+  // Calls task(0) ... task(tasks_count - 1) on the pool threads and the
+  // calling thread, returns when all of them are finished. The first
+  // exception thrown by a task is rethrown here.
+  void Run(size_t tasks_count, const std::function<void(size_t)>& task);
+  void SetThreadsCount(size_t threads_count);
+  size_t GetThreadsCount() const noexcept;
+
+ private:
+  void Start(size_t threads_count);
+  void Stop();
+  void WorkerLoop(size_t generation);
+  void ExecuteTasks();
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable start_condition_;
+  std::condition_variable done_condition_;
+  const std::function<void(size_t)>* task_ = nullptr;
+  size_t tasks_count_ = 0;
+  std::atomic<size_t> next_task_{0};
+  size_t generation_ = 0;
+  size_t active_workers_ = 0;
+  bool stop_ = false;
+  std::exception_ptr error_;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_THREAD_POOL_H_
@@ -0,0 +1,337 @@
+#include "weights_file.h"
+
+#include <limits>
+
+namespace s21 {
+namespace {
+template <class T, class U>
+void CopyTensors(const WeightsFile::MappedWeights& mapped,
+                 std::vector<S21Matrix<U>>& weights,
+                 std::vector<S21Matrix<U>>& biases) {
+  for (size_t layer = 0; layer < weights.size(); ++layer) {
+    const T* weights_data = mapped.GetWeights<T>(layer);
+    std::copy(weights_data, weights_data + weights[layer].GetSize(),
+              weights[layer].Data());
+    const T* biases_data = mapped.GetBiases<T>(layer);
+    std::copy(biases_data, biases_data + biases[layer].GetSize(),
+              biases[layer].Data());
+  }
+}
+}  // namespace
+
+WeightsFile::MappedWeights::MappedWeights(const std::string& path)
+    : file_(path) {
+  const char* data = file_.GetData();
+  size_t size = file_.GetSize();
+  auto invalid = [&path](const std::string& reason) {
+    return std::runtime_error("Invalid weights file " + path + ": " + reason);
+  };
+  if (size < sizeof(Header)) throw invalid("truncated header");
+  header_ = reinterpret_cast<const Header*>(data);
+  if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0)
+    throw invalid("bad magic");
+  if (header_->version != kVersion && header_->version != kUnlabeledVersion)
+    throw invalid("unsupported version");
+  size_t element_size =
+      GetElementSize(static_cast<DataType>(header_->data_type));
+  if (element_size == 0) throw invalid("unsupported data type");
+  if ((header_->functions & 0xff) >
+          static_cast<uint32_t>(ActivationFunction::kTanh) ||
+      (header_->functions >> 8) >
+          static_cast<uint32_t>(LossFunction::kCrossEntropy))
+    throw invalid("unknown functions");
+  if (header_->file_size != size) throw invalid("size mismatch");
+  if (header_->layers_count == 0 || header_->topology_offset > size ||
+      header_->topology_offset % alignof(uint32_t) != 0 ||
+      header_->topology_offset +
+              (header_->layers_count + 1) * sizeof(uint32_t) >
+          size)
+    throw invalid("bad topology");
+  if (Checksum(data + sizeof(Header), size - sizeof(Header)) !=
+      header_->checksum)
+    throw invalid("checksum mismatch");
+  topology_ =
+      reinterpret_cast<const uint32_t*>(data + header_->topology_offset);
+  for (size_t layer = 0; layer <= header_->layers_count; ++layer)
+    if (topology_[layer] == 0) throw invalid("empty layer");
+  labels_ = nullptr;
+  if (header_->version != kUnlabeledVersion) {
+    size_t labels_offset = header_->topology_offset +
+                           (header_->layers_count + 1) * sizeof(uint32_t);
+    if (labels_offset + topology_[header_->layers_count] >
+        header_->tensors_offset)
+      throw invalid("truncated labels");
+    labels_ = data + labels_offset;
+  }
+
+  if (header_->tensors_offset % kAlignment != 0)
+    throw invalid("misaligned tensors");
+  // Every tensor is bounded by the rest of the file before its size is
+  // added, so the offsets cannot wrap around.
+  size_t offset = header_->tensors_offset;
+  auto add_tensor = [&](size_t rows, size_t cols) {
+    if (offset > size || rows > (size - offset) / element_size / cols)
+      throw invalid("truncated tensors");
+    offsets_.push_back(offset);
+    offset = Align(offset + rows * cols * element_size);
+  };
+  for (size_t layer = 0; layer < header_->layers_count; ++layer) {
+    add_tensor(topology_[layer + 1], topology_[layer]);
+    add_tensor(topology_[layer + 1], 1);
+  }
+  if (offset > size) throw invalid("truncated tensors");
+}
+
+size_t WeightsFile::MappedWeights::GetLayersCount() const noexcept {
+  return header_->layers_count;
+}
+
+size_t WeightsFile::MappedWeights::GetNeuronsCount(
+    size_t layer) const noexcept {
+  return topology_[layer];
+}
+
+std::vector<size_t> WeightsFile::MappedWeights::GetLayerSizes() const {
+  return std::vector<size_t>(topology_, topology_ + header_->layers_count + 1);
+}
+
+WeightsFile::DataType WeightsFile::MappedWeights::GetDataType()
+    const noexcept {
+  return static_cast<DataType>(header_->data_type);
+}
+
+std::vector<char> WeightsFile::MappedWeights::GetLabels() const {
+  if (!labels_) return {};
+  return std::vector<char>(labels_,
+                           labels_ + topology_[header_->layers_count]);
+}
+
+template <class T>
+const T* WeightsFile::MappedWeights::GetWeights(size_t layer) const {
+  return GetTensor<T>(2 * layer);
+}
+
+template <class T>
+const T* WeightsFile::MappedWeights::GetBiases(size_t layer) const {
+  return GetTensor<T>(2 * layer + 1);
+}
+
+template <class T>
+const T* WeightsFile::MappedWeights::GetTensor(size_t index) const {
+  if (GetDataType() != WeightsFile::GetDataType<T>())
+    throw std::runtime_error("Weights are stored in another data type");
+  return reinterpret_cast<const T*>(file_.GetData() + offsets_[index]);
+}
+
+NetworkFunctions WeightsFile::MappedWeights::GetFunctions() const noexcept {
+  NetworkFunctions functions;
+  functions.activation =
+      static_cast<ActivationFunction>(header_->functions & 0xff);
+  functions.loss = static_cast<LossFunction>(header_->functions >> 8);
+  return functions;
+}
+
+template <class T>
+void WeightsFile::Save(const std::string& path,
+                       const std::vector<S21Matrix<T>>& weights,
+                       const std::vector<S21Matrix<T>>& biases,
+                       Format format, const NetworkFunctions& functions,
+                       const std::vector<char>& labels) {
+  if (format == Format::kText) return SaveText(path, weights, biases);
+  if (!labels.empty() &&
+      (weights.empty() || labels.size() != weights.back().GetRows()))
+    throw std::runtime_error("Labels do not match the output layer");
+
+  Header header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = labels.empty() ? kUnlabeledVersion : kVersion;
+  header.data_type = static_cast<uint32_t>(GetDataType<T>());
+  header.layers_count = weights.size();
+  header.functions = static_cast<uint32_t>(functions.activation) |
+                     static_cast<uint32_t>(functions.loss) << 8;
+  header.topology_offset = sizeof(Header);
+  size_t labels_offset =
+      header.topology_offset + (weights.size() + 1) * sizeof(uint32_t);
+  header.tensors_offset = Align(labels_offset + labels.size());
+
+  std::vector<size_t> offsets;
+  size_t offset = header.tensors_offset;
+  for (size_t layer = 0; layer < weights.size(); ++layer) {
+    offsets.push_back(offset);
+    offset = Align(offset + weights[layer].GetRows() *
+                                weights[layer].GetCols() * sizeof(T));
+    offsets.push_back(offset);
+    offset = Align(offset + biases[layer].GetRows() * sizeof(T));
+  }
+  header.file_size = offset;
+
+  std::vector<char> buffer(header.file_size);
+  auto topology =
+      reinterpret_cast<uint32_t*>(buffer.data() + header.topology_offset);
+  topology[0] = weights.empty() ? 0 : weights.front().GetCols();
+  std::memcpy(buffer.data() + labels_offset, labels.data(), labels.size());
+  for (size_t layer = 0; layer < weights.size(); ++layer) {
+    topology[layer + 1] = weights[layer].GetRows();
+    std::memcpy(buffer.data() + offsets[2 * layer], weights[layer].Data(),
+                weights[layer].GetSize() * sizeof(T));
+    std::memcpy(buffer.data() + offsets[2 * layer + 1], biases[layer].Data(),
+                biases[layer].GetSize() * sizeof(T));
+  }
+  header.checksum = Checksum(buffer.data() + sizeof(Header),
+                             buffer.size() - sizeof(Header));
+  std::memcpy(buffer.data(), &header, sizeof(Header));
+
+  std::ofstream file_stream(path, std::ios::binary);
+  if (!file_stream.is_open())
+    throw std::runtime_error("Unable to create file " + path);
+  file_stream.write(buffer.data(), buffer.size());
+  if (!file_stream.good())
+    throw std::runtime_error("Unable to write file " + path);
+}
+
+template <class T>
+bool WeightsFile::Load(const std::string& path,
+                       std::vector<S21Matrix<T>>& weights,
+                       std::vector<S21Matrix<T>>& biases,
+                       NetworkFunctions* functions,
+                       std::vector<char>* labels) {
+  if (!IsBinary(path)) return LoadText(path, weights, biases);
+  try {
+    MappedWeights mapped(path);
+    weights.resize(mapped.GetLayersCount());
+    biases.resize(mapped.GetLayersCount());
+    for (size_t layer = 0; layer < weights.size(); ++layer) {
+      size_t rows = mapped.GetNeuronsCount(layer + 1);
+      size_t cols = mapped.GetNeuronsCount(layer);
+      if (weights[layer].GetRows() != rows || weights[layer].GetCols() != cols)
+        weights[layer] = S21Matrix<T>(rows, cols);
+      if (biases[layer].GetRows() != rows || biases[layer].GetCols() != 1)
+        biases[layer] = S21Matrix<T>(rows, 1);
+    }
+    if (mapped.GetDataType() == DataType::kFloat32)
+      CopyTensors<float>(mapped, weights, biases);
+    else
+      CopyTensors<double>(mapped, weights, biases);
+    if (functions) *functions = mapped.GetFunctions();
+    if (labels) *labels = mapped.GetLabels();
+  } catch (const std::exception&) {
+    return false;
+  }
+  return true;
+}
+
+bool WeightsFile::IsBinary(const std::string& path) {
+  std::ifstream file_stream(path, std::ios::binary);
+  char magic[sizeof(kMagic)];
+  if (!file_stream.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, kMagic, sizeof(magic)) == 0;
+}
+
+size_t WeightsFile::GetElementSize(DataType data_type) noexcept {
+  switch (data_type) {
+    case DataType::kFloat32:
+      return sizeof(float);
+    case DataType::kFloat64:
+      return sizeof(double);
+  }
+  return 0;
+}
+
+size_t WeightsFile::Align(size_t offset) noexcept {
+  return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// 64-bit FNV-1a.
+uint64_t WeightsFile::Checksum(const char* data, size_t size) noexcept {
+  uint64_t hash = 14695981039346656037ull;
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 1099511628211ull;
+  }
+  return hash;
+}
+
+template <class T>
+void WeightsFile::SaveText(const std::string& path,
+                           const std::vector<S21Matrix<T>>& weights,
+                           const std::vector<S21Matrix<T>>& biases) {
+  std::ofstream file_stream;
+  file_stream.open(path);
+  // Enough digits for every value to read back exactly.
+  file_stream.precision(std::numeric_limits<T>::max_digits10);
+  for (size_t i = 0; i < weights.size(); ++i) {
+    for (size_t row = 0; row < weights[i].GetRows(); ++row) {
+      for (size_t col = 0; col < weights[i].GetCols(); ++col) {
+        file_stream << weights[i](row, col);
+        if (col != weights[i].GetCols() - 1) file_stream << ' ';
+      }
+      file_stream << '\n';
+    }
+  }
+
+  for (size_t i = 0; i < biases.size(); ++i) {
+    for (size_t row = 0; row < biases[i].GetRows(); ++row) {
+      file_stream << biases[i](row, 0);
+      file_stream << '\n';
+    }
+  }
+  if (file_stream.is_open()) file_stream.close();
+}
+
+template <class T>
+bool WeightsFile::LoadText(const std::string& path,
+                           std::vector<S21Matrix<T>>& weights,
+                           std::vector<S21Matrix<T>>& biases) {
+  std::ifstream file_stream;
+  file_stream.open(path);
+  if (!file_stream.is_open()) return false;
+
+  for (size_t i = 0; i < weights.size(); ++i) {
+    for (size_t row = 0; row < weights[i].GetRows(); ++row) {
+      for (size_t col = 0; col < weights[i].GetCols(); ++col) {
+        if (file_stream.eof()) {
+          file_stream.close();
+          return false;
+        }
+        file_stream >> weights[i](row, col);
+      }
+    }
+  }
+
+  for (size_t i = 0; i < biases.size(); ++i) {
+    for (size_t row = 0; row < biases[i].GetRows(); ++row) {
+      if (file_stream.eof()) {
+        file_stream.close();
+        return false;
+      }
+      file_stream >> biases[i](row, 0);
+    }
+  }
+
+  if (file_stream.is_open()) file_stream.close();
+  return true;
+}
+
+template const float* WeightsFile::MappedWeights::GetWeights(size_t) const;
+template const double* WeightsFile::MappedWeights::GetWeights(size_t) const;
+template const float* WeightsFile::MappedWeights::GetBiases(size_t) const;
+template const double* WeightsFile::MappedWeights::GetBiases(size_t) const;
+template void WeightsFile::Save(const std::string&,
+                                const std::vector<S21Matrix<float>>&,
+                                const std::vector<S21Matrix<float>>&, Format,
+                                const NetworkFunctions&,
+                                const std::vector<char>&);
+template void WeightsFile::Save(const std::string&,
+                                const std::vector<S21Matrix<double>>&,
+                                const std::vector<S21Matrix<double>>&, Format,
+                                const NetworkFunctions&,
+                                const std::vector<char>&);
+template bool WeightsFile::Load(const std::string&,
+                                std::vector<S21Matrix<float>>&,
+                                std::vector<S21Matrix<float>>&,
+                                NetworkFunctions*, std::vector<char>*);
+template bool WeightsFile::Load(const std::string&,
+                                std::vector<S21Matrix<double>>&,
+                                std::vector<S21Matrix<double>>&,
+                                NetworkFunctions*, std::vector<char>*);
+}  // namespace s21
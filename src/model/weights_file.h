@@ -0,0 +1,119 @@
+#ifndef CPP7_MLP_MODEL_WEIGHTS_FILE_H_
+#define CPP7_MLP_MODEL_WEIGHTS_FILE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "activation.h"
+#include "mapped_file.h"
+#include "s21_matrix.h"
+
+namespace s21 {
+class WeightsFile {
+ public:
+  enum class Format { kBinary = 0, kText = 1 };
+  enum class DataType : uint32_t { kFloat64 = 1, kFloat32 = 2 };
+
+  // Layout of a binary weights file: the header, layers_count + 1 neuron
+  // counts (input layer first) at topology_offset and then, for every layer,
+  // its weights (row-major) followed by its biases, all of data_type. Every
+  // tensor starts on a kAlignment boundary. Since version 2 the neuron
+  // counts are followed by one label byte per output neuron. The checksum
+  // covers everything after the header.
+  // functions holds the hidden activation in its low byte and the loss in
+  // the next one; zero is the sigmoid with the mean squared error.
+  struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t data_type;
+    uint32_t layers_count;
+    uint32_t functions;
+    uint64_t checksum;
+    uint64_t topology_offset;
+    uint64_t tensors_offset;
+    uint64_t file_size;
+  };
+
+  // Zero-copy view of a validated binary weights file.
+  class MappedWeights {
+   public:
+    explicit MappedWeights(const std::string& path);
+
+    size_t GetLayersCount() const noexcept;
+    size_t GetNeuronsCount(size_t layer) const noexcept;
+    // Neuron counts of all layers, the input layer first.
+    std::vector<size_t> GetLayerSizes() const;
+    DataType GetDataType() const noexcept;
+    // Label of every output neuron, empty for version 1 files.
+    std::vector<char> GetLabels() const;
+    // T has to match GetDataType().
+    template <class T>
+    const T* GetWeights(size_t layer) const;
+    template <class T>
+    const T* GetBiases(size_t layer) const;
+    NetworkFunctions GetFunctions() const noexcept;
+
+   private:
+    template <class T>
+    const T* GetTensor(size_t index) const;
+
+    MappedFile file_;
+    const Header* header_;
+    const uint32_t* topology_;
+    const char* labels_;
+    std::vector<size_t> offsets_;
+  };
+
+  static constexpr char kMagic[8] = {'S', '2', '1', 'M', 'L', 'P', 'W', 'T'};
+  static constexpr uint32_t kVersion = 2;
+  static constexpr uint32_t kUnlabeledVersion = 1;
+  static constexpr size_t kAlignment = 64;
+
+  // Binary files store float or double matrices as they are. labels holds
+  // one label per output neuron; without them a version 1 file is written.
+  template <class T>
+  static void Save(const std::string& path,
+                   const std::vector<S21Matrix<T>>& weights,
+                   const std::vector<S21Matrix<T>>& biases,
+                   Format format = Format::kBinary,
+                   const NetworkFunctions& functions = {},
+                   const std::vector<char>& labels = {});
+  // Binary files resize weights and biases to the topology they store and
+  // convert their values to T; labels is cleared for version 1 files. Text
+  // files record neither the topology, which weights and biases must
+  // already have, nor the functions and labels, which are then left as is.
+  template <class T>
+  static bool Load(const std::string& path,
+                   std::vector<S21Matrix<T>>& weights,
+                   std::vector<S21Matrix<T>>& biases,
+                   NetworkFunctions* functions = nullptr,
+                   std::vector<char>* labels = nullptr);
+  static bool IsBinary(const std::string& path);
+
+  template <class T>
+  static constexpr DataType GetDataType() noexcept {
+    static_assert(std::is_same_v<T, float> || std::is_same_v<T, double>,
+                  "Weights are float or double");
+    return std::is_same_v<T, float> ? DataType::kFloat32 : DataType::kFloat64;
+  }
+  static size_t GetElementSize(DataType data_type) noexcept;
+
+ private:
+  static size_t Align(size_t offset) noexcept;
+  static uint64_t Checksum(const char* data, size_t size) noexcept;
+  template <class T>
+  static void SaveText(const std::string& path,
+                       const std::vector<S21Matrix<T>>& weights,
+                       const std::vector<S21Matrix<T>>& biases);
+  template <class T>
+  static bool LoadText(const std::string& path,
+                       std::vector<S21Matrix<T>>& weights,
+                       std::vector<S21Matrix<T>>& biases);
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_MODEL_WEIGHTS_FILE_H_
@@ -0,0 +1,269 @@
+#include "inference_server.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace s21 {
+namespace {
+constexpr int kPollIntervalMs = 200;
+
+bool ReadFull(int fd, void* data, size_t size) {
+  auto bytes = static_cast<char*>(data);
+  while (size != 0) {
+    ssize_t read_count = recv(fd, bytes, size, 0);
+    if (read_count < 0 && errno == EINTR) continue;
+    if (read_count <= 0) return false;
+    bytes += read_count;
+    size -= read_count;
+  }
+  return true;
+}
+
+bool WriteFull(int fd, const void* data, size_t size) {
+  auto bytes = static_cast<const char*>(data);
+  while (size != 0) {
+    ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) continue;
+    if (written <= 0) return false;
+    bytes += written;
+    size -= written;
+  }
+  return true;
+}
+}  // namespace
+
+InferenceServer::InferenceServer(
+    std::shared_ptr<const InferenceModel<double>> model,
+    const Options& options)
+    : model_(std::move(model)), options_(options) {
+  if (!model_ || model_->GetInputsCount() != kImageSize)
+    throw std::runtime_error("Model does not accept 28x28 images");
+  if (options_.max_batch_size == 0)
+    throw std::runtime_error("Maximum batch size must be positive");
+}
+
+InferenceServer::~InferenceServer() { Stop(); }
+
+void InferenceServer::Run() {
+  int listener = Listen();
+  batcher_ = std::thread(&InferenceServer::BatchLoop, this);
+  while (!stopped_) {
+    pollfd poll_fd{listener, POLLIN, 0};
+    int ready = poll(&poll_fd, 1, kPollIntervalMs);
+    ReapConnections(false);
+    if (ready <= 0) continue;
+    int fd = accept(listener, nullptr, nullptr);
+    if (fd < 0) continue;
+    connections_.emplace_back();
+    auto& connection = connections_.back();
+    connection.fd = fd;
+    connection.thread = std::thread(&InferenceServer::ServeConnection, this,
+                                    std::ref(connection));
+  }
+  close(listener);
+  if (!options_.socket_path.empty()) unlink(options_.socket_path.c_str());
+
+  ReapConnections(true);
+  {
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    batcher_stopped_ = true;
+  }
+  queue_cv_.notify_one();
+  batcher_.join();
+}
+
+void InferenceServer::Stop() noexcept { stopped_ = true; }
+
+int InferenceServer::Listen() const {
+  int fd;
+  if (!options_.socket_path.empty()) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (options_.socket_path.size() >= sizeof(address.sun_path))
+      throw std::runtime_error("Socket path is too long");
+    std::strcpy(address.sun_path, options_.socket_path.c_str());
+    unlink(address.sun_path);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 ||
+        bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      if (fd >= 0) close(fd);
+      throw std::runtime_error("Unable to bind " + options_.socket_path);
+    }
+  } else {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(options_.port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fd = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    if (fd >= 0)
+      setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    if (fd < 0 ||
+        bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+      if (fd >= 0) close(fd);
+      throw std::runtime_error("Unable to bind port " +
+                               std::to_string(options_.port));
+    }
+  }
+  if (listen(fd, SOMAXCONN) != 0) {
+    close(fd);
+    throw std::runtime_error("Unable to listen on socket");
+  }
+  return fd;
+}
+
+void InferenceServer::ServeConnection(Connection& connection) {
+  RequestHeader header;
+  while (!stopped_ && ReadFull(connection.fd, &header, sizeof(header))) {
+    ResponseHeader response{header.images_count, header.top_k, 0, kOk, 0};
+    if (header.images_count == 0 ||
+        header.images_count > kMaxImagesPerRequest || header.top_k == 0 ||
+        header.top_k > model_->GetOutputsCount()) {
+      // The pixel block size is unknown, so the stream cannot be resynced.
+      response.images_count = 0;
+      response.status = kBadRequest;
+      WriteFull(connection.fd, &response, sizeof(response));
+      break;
+    }
+
+    Request request;
+    request.images_count = header.images_count;
+    request.top_k = header.top_k;
+    request.pixels.resize(request.images_count * kImageSize);
+    if (!ReadFull(connection.fd, request.pixels.data(), request.pixels.size()))
+      break;
+    auto start = std::chrono::steady_clock::now();
+    auto done = request.done.get_future();
+    {
+      std::lock_guard<std::mutex> lock(queue_mutex_);
+      queue_.emplace_back(&request, start);
+      queued_images_ += request.images_count;
+    }
+    queue_cv_.notify_one();
+    try {
+      done.get();
+    } catch (const std::exception&) {
+      response.images_count = 0;
+      response.status = kInternalError;
+    }
+    response.batch_size = request.batch_size;
+    response.latency_us =
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count();
+
+    std::vector<ResponseCandidate> candidates;
+    candidates.reserve(request.result.size() * request.top_k);
+    for (const auto& classification : request.result)
+      for (const auto& candidate : classification)
+        candidates.push_back({static_cast<float>(candidate.score),
+                              static_cast<unsigned char>(candidate.letter)});
+    if (!WriteFull(connection.fd, &response, sizeof(response)) ||
+        !WriteFull(connection.fd, candidates.data(),
+                   candidates.size() * sizeof(ResponseCandidate)))
+      break;
+    uint64_t request_id = requests_count_++;
+    if (options_.log_requests)
+      std::fprintf(stderr,
+                   "request=%llu images=%u batch=%u status=%u "
+                   "latency_us=%llu\n",
+                   static_cast<unsigned long long>(request_id),
+                   header.images_count, response.batch_size, response.status,
+                   static_cast<unsigned long long>(response.latency_us));
+  }
+  connection.finished = true;
+}
+
+void InferenceServer::BatchLoop() {
+  std::vector<Request*> batch;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(queue_mutex_);
+      queue_cv_.wait(lock,
+                     [this] { return batcher_stopped_ || !queue_.empty(); });
+      if (queue_.empty()) return;
+      queue_cv_.wait_until(
+          lock, queue_.front().second + options_.latency_budget, [this] {
+            return batcher_stopped_ ||
+                   queued_images_ >= options_.max_batch_size;
+          });
+      size_t images_count = 0;
+      batch.clear();
+      while (!queue_.empty()) {
+        Request* request = queue_.front().first;
+        if (!batch.empty() && images_count + request->images_count >
+                                  options_.max_batch_size)
+          break;
+        images_count += request->images_count;
+        queued_images_ -= request->images_count;
+        batch.push_back(request);
+        queue_.pop_front();
+      }
+    }
+    RunBatch(batch);
+  }
+}
+
+void InferenceServer::RunBatch(std::vector<Request*>& batch) {
+  size_t images_count = 0;
+  size_t top_k = 0;
+  for (auto request : batch) {
+    images_count += request->images_count;
+    top_k = std::max(top_k, request->top_k);
+  }
+
+  std::vector<InferenceModelBase::Classification> result;
+  try {
+    if (batch.size() == 1) {
+      result = model_->ClassifyBatch(batch.front()->pixels.data(),
+                                     images_count, top_k);
+    } else {
+      std::vector<uint8_t> pixels;
+      pixels.reserve(images_count * kImageSize);
+      for (auto request : batch)
+        pixels.insert(pixels.end(), request->pixels.begin(),
+                      request->pixels.end());
+      result = model_->ClassifyBatch(pixels.data(), images_count, top_k);
+    }
+  } catch (...) {
+    for (auto request : batch)
+      request->done.set_exception(std::current_exception());
+    return;
+  }
+
+  auto begin = result.begin();
+  for (auto request : batch) {
+    auto end = begin + request->images_count;
+    request->result.assign(std::make_move_iterator(begin),
+                           std::make_move_iterator(end));
+    for (auto& classification : request->result)
+      classification.resize(request->top_k);
+    request->batch_size = images_count;
+    request->done.set_value();
+    begin = end;
+  }
+}
+
+void InferenceServer::ReapConnections(bool all) {
+  for (auto it = connections_.begin(); it != connections_.end();) {
+    if (all && !it->finished) shutdown(it->fd, SHUT_RDWR);
+    if (all || it->finished) {
+      it->thread.join();
+      close(it->fd);
+      it = connections_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+}  // namespace s21
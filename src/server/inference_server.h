@@ -0,0 +1,110 @@
+#ifndef CPP7_MLP_SERVER_INFERENCE_SERVER_H_
+#define CPP7_MLP_SERVER_INFERENCE_SERVER_H_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "inference_model.h"
+
+namespace s21 {
+// Letter recognition service over a Unix domain socket or localhost TCP.
+// Every connection sends requests and reads responses in order:
+//   request:  RequestHeader, images_count * kImageSize pixels
+//   response: ResponseHeader, images_count * top_k ResponseCandidate
+// Requests from all connections are coalesced into micro-batches of at
+// most max_batch_size images; a batch is flushed as soon as it is full or
+// its oldest request has waited latency_budget.
+class InferenceServer {
+ public:
+  struct RequestHeader {
+    uint32_t images_count;
+    uint32_t top_k;
+  };
+
+  struct ResponseHeader {
+    uint32_t images_count;
+    uint32_t top_k;
+    uint32_t batch_size;
+    uint32_t status;
+    uint64_t latency_us;
+  };
+
+  struct ResponseCandidate {
+    float score;
+    uint32_t letter;
+  };
+
+  struct Options {
+    std::string socket_path;
+    uint16_t port = 0;
+    size_t max_batch_size = 256;
+    std::chrono::microseconds latency_budget{2000};
+    bool log_requests = false;
+  };
+
+  enum Status : uint32_t { kOk = 0, kBadRequest = 1, kInternalError = 2 };
+
+  static constexpr size_t kImageSize = 784;
+  static constexpr size_t kMaxImagesPerRequest = 65536;
+
+  InferenceServer(std::shared_ptr<const InferenceModel<double>> model,
+                  const Options& options);
+  InferenceServer(const InferenceServer& other) = delete;
+  InferenceServer(InferenceServer&& other) = delete;
+  InferenceServer& operator=(const InferenceServer& other) = delete;
+  InferenceServer& operator=(InferenceServer&& other) = delete;
+  ~InferenceServer();
+
+  // Accepts connections until Stop is called from another thread or a
+  // signal handler.
+  void Run();
+  void Stop() noexcept;
+
+ private:
+  struct Request {
+    std::vector<uint8_t> pixels;
+    size_t images_count;
+    size_t top_k;
+    size_t batch_size = 0;
+    std::vector<InferenceModelBase::Classification> result;
+    std::promise<void> done;
+  };
+
+  struct Connection {
+    int fd;
+    std::thread thread;
+    std::atomic<bool> finished{false};
+  };
+
+  int Listen() const;
+  void ServeConnection(Connection& connection);
+  void BatchLoop();
+  void RunBatch(std::vector<Request*>& batch);
+  void ReapConnections(bool all);
+
+  std::shared_ptr<const InferenceModel<double>> model_;
+  Options options_;
+  std::atomic<bool> stopped_{false};
+  std::atomic<uint64_t> requests_count_{0};
+  std::mutex queue_mutex_;
+  std::condition_variable queue_cv_;
+  std::deque<std::pair<Request*, std::chrono::steady_clock::time_point>>
+      queue_;
+  size_t queued_images_ = 0;
+  bool batcher_stopped_ = false;
+  std::thread batcher_;
+  std::list<Connection> connections_;
+};
+}  // namespace s21
+
+#endif  // CPP7_MLP_SERVER_INFERENCE_SERVER_H_
@@ -0,0 +1,100 @@
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+#include "command_line.h"
+#include "controller.h"
+#include "inference_server.h"
+
+namespace {
+s21::InferenceServer* server = nullptr;
+
+void HandleSignal(int) {
+  if (server) server->Stop();
+}
+
+void PrintUsage(const char* name) {
+  std::cerr << "Usage: " << name
+            << " --weights FILE [--hidden-layers N]"
+               " [--socket PATH | --port N]\n"
+               "       [--max-batch N] [--latency-budget-us N] [--log]\n"
+               "       [--generic-inference]\n";
+}
+
+// Weights files store the layer count as a 32-bit number.
+constexpr size_t kMaxHiddenLayersCount = UINT32_MAX;
+constexpr size_t kMaxPort = UINT16_MAX;
+constexpr size_t kMaxBatchSize = 65536;
+constexpr size_t kMaxLatencyBudgetUs = 60000000;
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::string weights_path;
+  size_t hidden_layers_count = 0;
+  bool static_inference = true;
+  s21::InferenceServer::Options options;
+  options.port = 7070;
+  using s21::CommandLine;
+  try {
+    for (int i = 1; i < argc; ++i) {
+      std::string arg = argv[i];
+      bool has_value = i + 1 < argc;
+      if (arg == "--weights" && has_value) {
+        weights_path = argv[++i];
+      } else if (arg == "--hidden-layers" && has_value) {
+        hidden_layers_count = CommandLine::ParseSize(arg, argv[++i], 0,
+                                                     kMaxHiddenLayersCount);
+      } else if (arg == "--socket" && has_value) {
+        options.socket_path = argv[++i];
+      } else if (arg == "--port" && has_value) {
+        options.port = CommandLine::ParseSize(arg, argv[++i], 1, kMaxPort);
+      } else if (arg == "--max-batch" && has_value) {
+        options.max_batch_size =
+            CommandLine::ParseSize(arg, argv[++i], 1, kMaxBatchSize);
+      } else if (arg == "--latency-budget-us" && has_value) {
+        options.latency_budget = std::chrono::microseconds(
+            CommandLine::ParseSize(arg, argv[++i], 0, kMaxLatencyBudgetUs));
+      } else if (arg == "--log") {
+        options.log_requests = true;
+      } else if (arg == "--generic-inference") {
+        static_inference = false;
+      } else {
+        throw s21::UsageError("Unknown option " + arg);
+      }
+    }
+    if (weights_path.empty())
+      throw s21::UsageError("Missing required option --weights");
+  } catch (const s21::UsageError& error) {
+    std::cerr << error.what() << '\n';
+    PrintUsage(argv[0]);
+    return 2;
+  }
+
+  try {
+    // Binary weights carry their topology; --hidden-layers is for text ones.
+    s21::Controller controller;
+    if (hidden_layers_count != 0)
+      controller.ChangeHiddenLayersNumber(hidden_layers_count);
+    controller.SetStaticInference(static_inference);
+    if (!controller.LoadWeightsAndBiases(weights_path))
+      throw std::runtime_error("Unable to load weights from " + weights_path);
+
+    s21::InferenceServer inference_server(controller.GetInferenceModel(),
+                                          options);
+    server = &inference_server;
+    std::signal(SIGINT, HandleSignal);
+    std::signal(SIGTERM, HandleSignal);
+    std::cerr << "listening on "
+              << (options.socket_path.empty()
+                      ? "127.0.0.1:" + std::to_string(options.port)
+                      : options.socket_path)
+              << '\n';
+    inference_server.Run();
+    server = nullptr;
+  } catch (const std::exception& error) {
+    std::cerr << error.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
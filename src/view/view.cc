@@ -167,12 +167,12 @@ void View::StartLearning() {
 
   QString file_name;
   file_name = QFileDialog::getOpenFileName(this, tr("Open train dataset"), ".",
-                                           tr("dataset files (*.csv)"));
+                                           tr("dataset files (*.csv *.bin)"));
   if (!file_name.isEmpty()) {
     data_path = file_name.toStdString();
 
     file_name = QFileDialog::getOpenFileName(this, tr("Open test dataset"), ".",
-                                             tr("dataset files (*.csv)"));
+                                             tr("dataset files (*.csv *.bin)"));
     if (!file_name.isEmpty()) {
       test_path = file_name.toStdString();
       file_name = QFileDialog::getOpenFileName(
@@ -212,7 +212,7 @@ void View::StartLearningValidation() {
 
   QString file_name;
   file_name = QFileDialog::getOpenFileName(this, tr("Open train dataset"), ".",
-                                           tr("dataset files (*.csv)"));
+                                           tr("dataset files (*.csv *.bin)"));
   if (!file_name.isEmpty()) {
     data_path = file_name.toStdString();
     file_name = QFileDialog::getOpenFileName(this, tr("Open mapping file"), ".",
@@ -242,7 +242,7 @@ void View::RunTest() {
 
   QString file_name;
   file_name = QFileDialog::getOpenFileName(this, tr("Open train dataset"), ".",
-                                           tr("dataset files (*.csv)"));
+                                           tr("dataset files (*.csv *.bin)"));
   if (!file_name.isEmpty()) {
     data_path = file_name.toStdString();
     file_name = QFileDialog::getOpenFileName(this, tr("Open mapping file"), ".",
@@ -267,7 +267,8 @@ void View::RunTest() {
 
 void View::LoadPerceptron() {
   auto file_name = QFileDialog::getOpenFileName(
-      this, tr("Open weights from file"), ".", tr("weights files (*.txt)"));
+      this, tr("Open weights from file"), ".",
+      tr("weights files (*.bin *.txt)"));
   if (!file_name.isEmpty()) {
     controller_.LoadWeightsAndBiases(file_name.toStdString());
   }
@@ -275,9 +276,13 @@ void View::LoadPerceptron() {
 
 void View::SavePerceptron() {
   auto file_name = QFileDialog::getSaveFileName(
-      this, tr("Save weights to file"), ".", tr("weights files (*.txt)"));
+      this, tr("Save weights to file"), ".",
+      tr("binary weights (*.bin);;text weights (*.txt)"));
   if (!file_name.isEmpty()) {
-    controller_.SaveWeightsAndBiases(file_name.toStdString());
+    auto format = file_name.endsWith(".txt", Qt::CaseInsensitive)
+                      ? WeightsFile::Format::kText
+                      : WeightsFile::Format::kBinary;
+    controller_.SaveWeightsAndBiases(file_name.toStdString(), format);
   }
 }
 